@@ -0,0 +1,127 @@
+/*
+ * PRISM Engine V0.7
+ * Search Benchmark: Node Counts, Frontier Pruning and Evaluation Cache Hits
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "prism-engine.h"
+
+// One benchmark position: the board and castling state after a random opening
+struct BenchPosition {
+    Position position;
+    bool whiteToMove;
+};
+
+// Totals of one pass over the positions
+struct BenchRun {
+    long long nodes = 0;
+    long long leaves = 0;
+    long long evalProbes = 0;
+    long long evalHits = 0;
+    double seconds = 0.0;
+    vector<int> moves;
+};
+
+BenchRun runBench(const Evaluator& evaluator, const FrontierPruning& pruning, const vector<BenchPosition>& positions, int depth) {
+    BenchRun run;
+    Search search(evaluator); // each pass starts with a cold cache
+    search.pruning = pruning;
+    for (const BenchPosition& position : positions) {
+        game = position.position;
+
+        auto start = chrono::steady_clock::now();
+        int move = search.bestMove(game, depth, position.whiteToMove);
+        run.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        run.moves.push_back(move);
+    }
+    run.nodes = search.nodes;
+    run.leaves = search.leaves;
+    run.evalProbes = search.cacheProbes;
+    run.evalHits = search.cacheHits;
+    return run;
+}
+
+void printRun(const char* name, const BenchRun& run) {
+    printf("%-10s %14lld %14lld %10.2f %12.0f %9.1f%%\n", name, run.nodes, run.leaves, run.seconds,
+           (run.nodes + run.leaves) / max(run.seconds, 1e-9), 100.0 * run.evalHits / max(run.evalProbes, 1LL));
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <bot> [options]\n";
+    cout << "Options:\n";
+    cout << "  --depth <n>            search depth (default " << engineDepth << ")\n";
+    cout << "  --positions <n>        random opening positions searched (default 50)\n";
+    cout << "  --seed <n>             seed for the openings (default 1)\n";
+    printPruningUsage();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string botFile = argv[1];
+    int depth = engineDepth;
+    int count = 50;
+    unsigned int seed = 1;
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--depth" && hasValue) {
+            depth = max(1, stoi(argv[++i]));
+        } else if (arg == "--positions" && hasValue) {
+            count = max(1, stoi(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            seed = stoul(argv[++i]);
+        } else if (parsePruningOption(argc, argv, i)) {
+            // margins of the pruned run
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    BotWeights weights;
+    importPieceSquareTables(botFile, weights, false);
+    Evaluator evaluator(weights);
+
+    // openings of 6 to 29 random plies, middlegames included
+    mt19937 gen(seed);
+    vector<BenchPosition> positions(count);
+    for (BenchPosition& position : positions) {
+        resetGame();
+        position.whiteToMove = playRandomOpening(gen(), 6 + gen() % 24);
+        position.position = game;
+        position.position.history.clear(); // the search starts its own from the root
+        position.position.undoStack.clear();
+    }
+
+    bool counting = perfOpen(); // only in a PERF=1 build, the searches run slower for it
+    cout << "Searching " << count << " positions at depth " << depth << " with " << botFile << "\n";
+    printf("%-10s %14s %14s %10s %12s %10s\n", "", "nodes", "leaves", "seconds", "per second", "eval hits");
+
+    perfReset();
+    BenchRun full = runBench(evaluator, {0, 0, 0}, positions, depth);
+    printRun("unpruned", full);
+    if (counting) perfReport("unpruned");
+
+    FrontierPruning pruned = frontierPruning;
+    perfReset();
+    BenchRun run = runBench(evaluator, pruned, positions, depth);
+    printRun("pruned", run);
+    if (counting) perfReport("pruned");
+
+    int same = 0;
+    for (int i = 0; i < count; i++) {
+        if (run.moves[i] == full.moves[i]) same++;
+    }
+    printf("Margins %d%%, %d%%, %d%%: %.1f%% fewer nodes, %.1f%% fewer leaves, same move in %d of %d positions\n",
+           pruned.futility1, pruned.futility2, pruned.razor3,
+           100.0 * (1.0 - (double)run.nodes / max(full.nodes, 1LL)),
+           100.0 * (1.0 - (double)run.leaves / max(full.leaves, 1LL)), same, count);
+
+    return 0;
+}
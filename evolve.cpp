@@ -0,0 +1,259 @@
+/*
+ * PRISM Engine V0.7
+ * In-Process Steady State Evolution
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "prism-engine.h"
+#include "prism-mutation.h"
+
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+
+// One bot in the population
+struct Member {
+    BotWeights weights;
+    double elo = 0.0;
+    int games = 0;
+    int born = 0;  // step it was created in
+    string file;   // bot file the slot is snapshotted to
+};
+
+// Evolution settings
+struct EvolveConfig {
+    int population = 0;          // 0 = as many bots as the directory holds
+    long steps = 0;              // 0 = run until interrupted
+    long snapshotEvery = 100;
+    double mutationFactor = 0.05;
+    double crossoverRate = 0.5;
+    int openingPlies = 6;
+    unsigned int seed = 0;
+    string recordFile;           // binary game log, empty to keep none
+};
+
+volatile sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+// Bot weights viewed as the 714 values of a bot file, in file order
+inline int* botValues(BotWeights& weights) {
+    return &weights.materialValues[0];
+}
+
+// Best rated of a few random members
+int tournamentSelect(const vector<Member>& population, int size, mt19937& gen) {
+    uniform_int_distribution<> pick(0, population.size() - 1);
+    int best = pick(gen);
+    for (int i = 1; i < size; i++) {
+        int candidate = pick(gen);
+        if (population[candidate].elo > population[best].elo) best = candidate;
+    }
+    return best;
+}
+
+// Write every slot over its bot file plus a summary, each file via rename so a kill never leaves half a bot
+void writeSnapshot(const string& directory, const vector<Member>& population, long step) {
+    for (const Member& member : population) {
+        writeBotWeights(member.file + ".tmp", member.weights);
+        rename((member.file + ".tmp").c_str(), member.file.c_str());
+    }
+
+    // not *.txt so the tournament tools never take it for a bot
+    string summary = directory + "/evolve.population";
+    ofstream out(summary + ".tmp");
+    out << "step " << step << "\n";
+    for (size_t i = 0; i < population.size(); i++) {
+        out << getFilename(population[i].file) << " elo " << population[i].elo << " games " << population[i].games
+            << " born " << population[i].born << "\n";
+    }
+    out.close();
+    rename((summary + ".tmp").c_str(), summary.c_str());
+}
+
+void printLeaders(const vector<Member>& population, size_t limit) {
+    vector<int> order(population.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return population[a].elo > population[b].elo;
+    });
+    for (size_t i = 0; i < order.size() && i < limit; i++) {
+        const Member& member = population[order[i]];
+        printf("  %-20s elo %+7.1f  games %d  born %d\n", getFilename(member.file).c_str(), member.elo, member.games, member.born);
+    }
+    fflush(stdout);
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <bots_directory> [options]\n";
+    cout << "Options:\n";
+    cout << "  --population <n>       population size, missing bots are generated (default: bots found)\n";
+    cout << "  --steps <n>            matches to play, 0 runs until interrupted (default 0)\n";
+    cout << "  --snapshot-every <n>   steps between population snapshots (default 100)\n";
+    cout << "  --mutation-factor <f>  chance each value mutates (default 0.05)\n";
+    cout << "  --crossover-rate <p>   chance a child has two parents (default 0.5)\n";
+    cout << "  --opening-plies <n>    random opening plies per pair (default 6)\n";
+    cout << "  --depth <n>            search depth (default " << engineDepth << ")\n";
+    cout << "  --seed <n>             random seed (default random)\n";
+    cout << "  --record <file>        append every game to a binary game log (see extract)\n";
+    printAdjudicationUsage();
+    printTimeControlUsage();
+    printPruningUsage();
+}
+
+int main(int argc, char* argv[]) {
+    cout.setf(ios::unitbuf); // Enable unbuffered output
+
+    string botsDir;
+    EvolveConfig config;
+    config.seed = random_device()();
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--population" && hasValue) {
+            config.population = stoi(argv[++i]);
+        } else if (arg == "--steps" && hasValue) {
+            config.steps = stol(argv[++i]);
+        } else if (arg == "--snapshot-every" && hasValue) {
+            config.snapshotEvery = stol(argv[++i]);
+        } else if (arg == "--mutation-factor" && hasValue) {
+            config.mutationFactor = stod(argv[++i]);
+        } else if (arg == "--crossover-rate" && hasValue) {
+            config.crossoverRate = stod(argv[++i]);
+        } else if (arg == "--opening-plies" && hasValue) {
+            config.openingPlies = stoi(argv[++i]);
+        } else if (arg == "--depth" && hasValue) {
+            engineDepth = stoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = stoul(argv[++i]);
+        } else if (arg == "--record" && hasValue) {
+            config.recordFile = argv[++i];
+        } else if (parseAdjudicationOption(argc, argv, i)) {
+            // resign and draw rules
+        } else if (parseTimeControlOption(argc, argv, i)) {
+            // clocks
+        } else if (parsePruningOption(argc, argv, i)) {
+            // search margins
+        } else if (arg[0] != '-' && botsDir.empty()) {
+            botsDir = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (botsDir.empty() || config.snapshotEvery < 1 || config.mutationFactor < 0.0 || config.mutationFactor > 1.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Remove trailing slash
+    if (botsDir.back() == '/') {
+        botsDir.pop_back();
+    }
+
+    mt19937 gen(config.seed);
+    FastRandom valueRandom(config.seed); // random bots, crossover and mutation, as in generate and mutate
+
+    // load what is there, then top up with random bots
+    vector<Member> population;
+    for (const string& file : getBotFiles(botsDir)) {
+        if (config.population > 0 && (int)population.size() >= config.population) break;
+        Member member;
+        importPieceSquareTables(file, member.weights);
+        member.file = file;
+        population.push_back(member);
+    }
+    int nextName = 0;
+    while ((int)population.size() < max(config.population, 2)) {
+        Member member;
+        randomizeBotValues(botValues(member.weights), valueRandom);
+        // first bot_<n>.txt not already taken
+        do {
+            member.file = botsDir + "/bot_" + to_string(nextName++) + ".txt";
+        } while (ifstream(member.file).good());
+        population.push_back(member);
+    }
+
+    cout << "Evolving " << population.size() << " bots in " << botsDir << " (seed " << config.seed << ")\n";
+    cout.flush();
+
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+
+    uniform_int_distribution<> pick(0, population.size() - 1);
+    uniform_real_distribution<> chance(0.0, 1.0);
+    Timer timer;
+    timer.start();
+    long step = 0;
+
+    while (!stopRequested && (config.steps == 0 || step < config.steps)) {
+        step++;
+
+        // two random members play a color swapped pair
+        int a = pick(gen);
+        int b = pick(gen);
+        while (b == a) b = pick(gen);
+
+        unsigned int openingSeed = gen();
+        int eval1 = 0;
+        int eval2 = 0;
+        int result1 = playGame(population[a].weights, population[b].weights, openingSeed, config.openingPlies, eval1, false);
+        if (!config.recordFile.empty()) appendGameRecord(config.recordFile, population[a].weights, population[b].weights, result1);
+        int result2 = playGame(population[b].weights, population[a].weights, openingSeed, config.openingPlies, eval2, false);
+        if (!config.recordFile.empty()) appendGameRecord(config.recordFile, population[b].weights, population[a].weights, result2);
+        int points = (result1 + 1) + (1 - result2); // a's half points out of 4
+        int evalSum = (result1 == 0 ? eval1 : 0) - (result2 == 0 ? eval2 : 0);
+
+        // incremental elo, K = 16 per game
+        double expected = 1.0 / (1.0 + pow(10.0, (population[b].elo - population[a].elo) / 400.0));
+        double change = 16.0 * (points / 2.0 - 2.0 * expected);
+        population[a].elo += change;
+        population[b].elo -= change;
+        population[a].games += 2;
+        population[b].games += 2;
+
+        int winner;
+        if (points != 2) {
+            winner = points > 2 ? a : b;
+        } else if (evalSum != 0) {
+            winner = evalSum > 0 ? a : b;
+        } else {
+            winner = chance(gen) < 0.5 ? a : b;
+        }
+        int loser = winner == a ? b : a;
+
+        // the loser's slot goes to a child of the winner
+        BotWeights child = population[winner].weights;
+        if (chance(gen) < config.crossoverRate) {
+            int mate = tournamentSelect(population, 3, gen);
+            if (mate != winner && mate != loser) {
+                const int* parents[2] = {botValues(population[winner].weights), botValues(population[mate].weights)};
+                uniformCrossover(parents, 2, botValues(child), valueRandom);
+            }
+        }
+        mutateBotValues(botValues(child), config.mutationFactor, valueRandom);
+
+        population[loser].weights = child;
+        population[loser].elo = population[winner].elo;
+        population[loser].games = 0;
+        population[loser].born = step;
+
+        if (step % config.snapshotEvery == 0) {
+            timer.stop();
+            writeSnapshot(botsDir, population, step);
+            cout << "Step " << step << ": snapshot written, " << timer.getTime() << "s elapsed, leaders:\n";
+            printLeaders(population, 5);
+        }
+    }
+
+    writeSnapshot(botsDir, population, step);
+    cout << "Stopped after " << step << " steps, final population written to " << botsDir << "/\n";
+    printLeaders(population, population.size());
+
+    return 0;
+}
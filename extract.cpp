@@ -0,0 +1,181 @@
+/*
+ * PRISM Engine V0.7
+ * Training Position Extraction from Game Records
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "prism-engine.h"
+
+// Extraction settings
+struct ExtractConfig {
+    int skipPlies = 8;     // leave out the random opening and the plies right after it
+    int perGame = 0;       // 0 = every quiet position
+    unsigned int seed = 0;
+    bool append = false;
+};
+
+bool hasCapture(const vector<int>& moves) {
+    for (int move : moves) {
+        if (game.board[getToRank(move)][getToFile(move)] != '.') return true;
+    }
+    return false;
+}
+
+// Quiet: the side to move has nothing to capture and its king is not attacked
+bool isQuiet(bool whiteToMove) {
+    if (hasCapture(game.generateMoves(whiteToMove))) return false;
+    for (int move : game.generateMoves(!whiteToMove)) {
+        if (tolower(game.board[getToRank(move)][getToFile(move)]) == 'k') return false;
+    }
+    return true;
+}
+
+// Replay one game and collect its quiet positions, false if a move does not fit the board
+bool extractGame(const GameRecordHeader& header, const vector<uint16_t>& moves, const ExtractConfig& config,
+                 mt19937& gen, vector<TrainingRecord>& out) {
+    resetGame();
+    vector<TrainingRecord> candidates;
+    bool whiteToMove = true;
+
+    for (size_t ply = 0; ply < moves.size(); ply++) {
+        int move = unpackMove(moves[ply]);
+        char piece = game.board[getFromRank(move)][getFromFile(move)];
+        // logs recorded by older builds hold move 0 (a8a8) where their search found every move losing,
+        // replay it exactly as it was played
+        bool nullMove = getFromRank(move) == getToRank(move) && getFromFile(move) == getToFile(move);
+        if (!nullMove && (piece == '.' || (isupper(piece) != 0) != whiteToMove)) return false;
+
+        if ((int)ply >= config.skipPlies && isQuiet(whiteToMove)) {
+            TrainingRecord record;
+            packBoard(record.squares);
+            record.whiteToMove = whiteToMove;
+            record.result = header.result;
+            record.ply = ply;
+            candidates.push_back(record);
+        }
+
+        executeMove(move, whiteToMove);
+        whiteToMove = !whiteToMove;
+    }
+
+    if (config.perGame > 0 && (int)candidates.size() > config.perGame) {
+        shuffle(candidates.begin(), candidates.end(), gen);
+        candidates.resize(config.perGame);
+    }
+    out.insert(out.end(), candidates.begin(), candidates.end());
+    return true;
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <game_log> <output> [options]\n";
+    cout << "Options:\n";
+    cout << "  --skip-plies <n>       plies at the start of each game to leave out (default 8)\n";
+    cout << "  --per-game <n>         quiet positions sampled per game, 0 keeps all (default 0)\n";
+    cout << "  --seed <n>             sampling seed (default 0)\n";
+    cout << "  --append               add to an existing training file instead of replacing it\n";
+}
+
+int main(int argc, char* argv[]) {
+    cout.setf(ios::unitbuf); // Enable unbuffered output
+
+    string logFile, outputFile;
+    ExtractConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--skip-plies" && hasValue) {
+            config.skipPlies = stoi(argv[++i]);
+        } else if (arg == "--per-game" && hasValue) {
+            config.perGame = stoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = stoul(argv[++i]);
+        } else if (arg == "--append") {
+            config.append = true;
+        } else if (arg[0] != '-' && logFile.empty()) {
+            logFile = arg;
+        } else if (arg[0] != '-' && outputFile.empty()) {
+            outputFile = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (logFile.empty() || outputFile.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(logFile.c_str(), "rb");
+    if (!in) {
+        cout << "Error: Could not open " << logFile << "\n";
+        return 1;
+    }
+
+    // a new file starts with the tag, an appended one must already have it
+    FILE* out;
+    if (config.append && (out = fopen(outputFile.c_str(), "rb")) != nullptr) {
+        char tag[8];
+        bool tagged = fread(tag, 1, 8, out) == 8 && memcmp(tag, trainingFileTag, 8) == 0;
+        fclose(out);
+        if (!tagged) {
+            cout << "Error: " << outputFile << " is not a training file\n";
+            fclose(in);
+            return 1;
+        }
+        out = fopen(outputFile.c_str(), "ab");
+    } else {
+        out = fopen(outputFile.c_str(), "wb");
+        if (out) fwrite(trainingFileTag, 1, 8, out);
+    }
+    if (!out) {
+        cout << "Error: Could not create " << outputFile << "\n";
+        fclose(in);
+        return 1;
+    }
+
+    mt19937 gen(config.seed);
+    long games = 0, skipped = 0, positions = 0;
+    int results[3] = {0, 0, 0};
+    GameRecordHeader header;
+    vector<uint16_t> moves;
+    vector<TrainingRecord> records;
+
+    while (fread(&header, sizeof(header), 1, in) == 1) {
+        if (header.magic != gameRecordMagic || header.result < -1 || header.result > 1) {
+            cout << "Error: Game log is corrupt after " << games << " games\n";
+            break;
+        }
+        moves.resize(header.moveCount);
+        if (fread(moves.data(), 2, moves.size(), in) != moves.size()) {
+            cout << "Warning: Last game is truncated\n";
+            break;
+        }
+        games++;
+
+        records.clear();
+        if (!extractGame(header, moves, config, gen, records)) {
+            skipped++;
+            continue;
+        }
+        results[header.result + 1]++;
+        fwrite(records.data(), sizeof(TrainingRecord), records.size(), out);
+        positions += records.size();
+    }
+    fclose(in);
+
+    if (fclose(out) != 0) {
+        cout << "Error: Could not write " << outputFile << "\n";
+        return 1;
+    }
+
+    cout << "Read " << games << " games (" << results[2] << " white wins, " << results[0] << " black wins, "
+         << results[1] << " draws)";
+    if (skipped > 0) cout << ", skipped " << skipped << " that did not replay";
+    cout << "\n";
+    cout << "Wrote " << positions << " quiet positions to " << outputFile << "\n";
+
+    return 0;
+}
@@ -3,6 +3,8 @@
 #include <string>
 #include <random>
 
+#include "prism-mutation.h"
+
 using namespace std;
 
 // Generate random bot
@@ -14,23 +16,24 @@ void generateRandomBot(const string& filename) {
     }
     
     random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> matDis(5, 200);      // Material values range
-    uniform_int_distribution<> pstDis(-100, 100);   // Position table values range
+    FastRandom rng(((uint64_t)rd() << 32) | rd());
+    int values[botValueCount];
+    randomizeBotValues(values, rng);
+    const int* value = values;
     
-    // Generate material values (6 values)
+    // Write material values (6 values)
     for (int i = 0; i < 6; i++) {
-        outFile << matDis(gen);
+        outFile << *value++;
         if (i < 5) outFile << " ";
     }
     outFile << "\n";
     
-    // Generate position PST (48 groups of 8 = 384 values)
+    // Write position PST (48 groups of 8 = 384 values)
     int count = 0;
     for (int piece = 0; piece < 6; piece++) {
         for (int rank = 0; rank < 8; rank++) {
             for (int file = 0; file < 8; file++) {
-                outFile << pstDis(gen);
+                outFile << *value++;
                 count++;
                 if (count % 8 == 0) {
                     outFile << "\n";
@@ -41,13 +44,13 @@ void generateRandomBot(const string& filename) {
         }
     }
     
-    // Generate neighbor PST (54 groups of 6 = 324 values)
+    // Write neighbor PST (54 groups of 6 = 324 values)
     count = 0;
     for (int piece = 0; piece < 6; piece++) {
         for (int neighbor = 0; neighbor < 6; neighbor++) {
             for (int row = 0; row < 3; row++) {
                 for (int col = 0; col < 3; col++) {
-                    outFile << pstDis(gen);
+                    outFile << *value++;
                     count++;
                     if (count % 6 == 0) {
                         outFile << "\n";
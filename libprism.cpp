@@ -0,0 +1,1084 @@
+/*
+ * PRISM Engine V0.7
+ * Engine library: move generation, evaluation and search
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "libprism.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#ifdef PRISM_PERF
+#include <cstdio>
+#endif
+#if defined(PRISM_PERF) && defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+Position::Position() {
+    reset();
+}
+
+void Position::reset() {
+    const char* blackPieces = "rnbqkbnr";
+    const char* whitePieces = "RNBQKBNR";
+
+    for (int i = 0; i < 8; i++) {
+        board[0][i] = blackPieces[i];
+        board[1][i] = 'p';
+        board[6][i] = 'P';
+        board[7][i] = whitePieces[i];
+        for (int j = 2; j < 6; j++) {
+            board[j][i] = '.';
+        }
+    }
+    whiteKingMoved = blackKingMoved = false;
+    whiteLeftRookMoved = whiteRightRookMoved = false;
+    blackLeftRookMoved = blackRightRookMoved = false;
+    whiteCastled = blackCastled = false;
+    history.clear();
+    undoStack.clear();
+}
+
+bool Position::setFromFEN(const string& placement) {
+    int row = 0;
+    int col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (col != 8) return false;
+            row++;
+            col = 0;
+        } else if (isdigit(c)) {
+            for (int n = 0; n < c - '0' && col < 8; n++) board[row][col++] = '.';
+        } else {
+            if (pieceToIndex(c) == -1 || row > 7 || col > 7) return false;
+            board[row][col++] = c;
+        }
+    }
+    return row == 7 && col == 8;
+}
+
+uint8_t Position::castlingState() const {
+    return whiteKingMoved | whiteLeftRookMoved << 1 | whiteRightRookMoved << 2 | blackKingMoved << 3
+         | blackLeftRookMoved << 4 | blackRightRookMoved << 5 | whiteCastled << 6 | blackCastled << 7;
+}
+
+void Position::setCastlingState(uint8_t state) {
+    whiteKingMoved = state & 1;
+    whiteLeftRookMoved = state & 2;
+    whiteRightRookMoved = state & 4;
+    blackKingMoved = state & 8;
+    blackLeftRookMoved = state & 16;
+    blackRightRookMoved = state & 32;
+    whiteCastled = state & 64;
+    blackCastled = state & 128;
+}
+
+void Position::makeMove(int move, bool whiteToMove) {
+    PERF_SCOPE(perfMakeUnmake);
+    int r = getFromRank(move);
+    int f = getFromFile(move);
+    int tr = getToRank(move);
+    int tf = getToFile(move);
+    int flag = getMoveFlag(move);
+    undoStack.push_back({move, board[tr][tf], castlingState()});
+
+    board[tr][tf] = board[r][f];
+    board[r][f] = '.';
+
+    const int rank = whiteToMove ? 7 : 0;
+    if (r == rank) { // anything leaving the king's or a rook's home square
+        if (f == 4) (whiteToMove ? whiteKingMoved : blackKingMoved) = true;
+        if (f == 0) (whiteToMove ? whiteLeftRookMoved : blackLeftRookMoved) = true;
+        if (f == 7) (whiteToMove ? whiteRightRookMoved : blackRightRookMoved) = true;
+    }
+    if (flag != 0) { // castling also moves the rook
+        char rook = whiteToMove ? 'R' : 'r';
+        board[rank][flag == 1 ? 5 : 3] = rook;
+        board[rank][flag == 1 ? 7 : 0] = '.';
+        (whiteToMove ? whiteCastled : blackCastled) = true;
+    }
+}
+
+void Position::unmakeMove() {
+    PERF_SCOPE(perfMakeUnmake);
+    MoveUndo undo = undoStack.back();
+    undoStack.pop_back();
+    int r = getFromRank(undo.move);
+    int f = getFromFile(undo.move);
+    int tr = getToRank(undo.move);
+    int tf = getToFile(undo.move);
+    int flag = getMoveFlag(undo.move);
+
+    board[r][f] = board[tr][tf];
+    board[tr][tf] = undo.captured;
+    if (flag != 0) { // the rook goes back to its corner
+        char rook = board[r][f] == 'K' ? 'R' : 'r';
+        board[r][flag == 1 ? 7 : 0] = rook;
+        board[r][flag == 1 ? 5 : 3] = '.';
+    }
+    setCastlingState(undo.castling);
+}
+
+// Color tests resolved at compile time for the side the moves are generated for
+template <bool white>
+static inline bool isOwnPiece(char piece) {
+    return white ? isupper(piece) : islower(piece);
+}
+
+template <bool white>
+static inline bool isEnemyPiece(char piece) {
+    return white ? islower(piece) : isupper(piece);
+}
+
+template <bool white>
+static void addPawnMoves(const Position& position, int r, int f, vector<int>& moves) { // list all possible pawn moves for a given pawn
+    const auto& board = position.board;
+    const int direction = white ? -1 : 1; // forwards direction of pawn
+
+    if (inBounds(r + direction, f) && board[r + direction][f] == '.') { // check if square in front is empty
+        moves.push_back(encodeMove(r, f, r + direction, f));
+        if (r == (white ? 6 : 1)) { // check if pawn is on starting square
+            if (inBounds(r + 2 * direction, f) && board[r + 2 * direction][f] == '.') { // then check two ahead
+                moves.push_back(encodeMove(r, f, r + 2*direction, f));
+            }
+        }
+    }
+
+    // captures
+    if (inBounds(r + direction, f - 1) && isEnemyPiece<white>(board[r + direction][f - 1])) {
+        moves.push_back(encodeMove(r, f, r + direction, f - 1));
+    }
+
+    if (inBounds(r + direction, f + 1) && isEnemyPiece<white>(board[r + direction][f + 1])) {
+        moves.push_back(encodeMove(r, f, r + direction, f + 1));
+    }
+}
+
+const int knightMoves[8][2] = {{2, -1}, {2, 1}, {-2, -1}, {-2, 1}, {1, -2}, {1, 2}, {-1, -2}, {-1, 2}}; // knight move patterns
+
+template <bool white>
+static void addKnightMoves(const Position& position, int r, int f, vector<int>& moves) { // list all possible knight moves for a given knight
+    for (int i = 0; i < 8; i++) { // check each knight move pattern, capture or open square
+        int tr = r + knightMoves[i][0];
+        int tf = f + knightMoves[i][1];
+        if (inBounds(tr, tf) && !isOwnPiece<white>(position.board[tr][tf])) {
+            moves.push_back(encodeMove(r, f, tr, tf));
+        }
+    }
+}
+
+// Bishop, rook and queen moves along the given directions
+template <bool white>
+static void addSlidingMoves(const Position& position, int r, int f, const int (*directions)[2], int count, vector<int>& moves) {
+    const auto& board = position.board;
+    for (int i = 0; i < count; i++) {
+        int dr = directions[i][0];
+        int df = directions[i][1];
+        int tr = r + dr;
+        int tf = f + df;
+        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
+            if (board[tr][tf] == '.') {
+                moves.push_back(encodeMove(r, f, tr, tf));
+            } else {
+                if (isEnemyPiece<white>(board[tr][tf])) { // capture if blocked by other color
+                    moves.push_back(encodeMove(r, f, tr, tf));
+                }
+                break;
+            }
+            tr += dr;
+            tf += df;
+        }
+    }
+}
+
+// Queen directions, rooks use the first four and bishops the last four
+const int slidingDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+template <bool white>
+static void addKingMoves(const Position& position, int r, int f, vector<int>& moves) { // list all possible king moves for a given king
+    const auto& board = position.board;
+    for (int i = 0; i < 8; i++) {
+        int tr = r + slidingDirections[i][0];
+        int tf = f + slidingDirections[i][1];
+        if (inBounds(tr, tf) && !isOwnPiece<white>(board[tr][tf])) {
+            moves.push_back(encodeMove(r, f, tr, tf));
+        }
+    }
+    // castling, the rook may have been captured without moving and a board set up by hand may
+    // keep the rights with the king elsewhere
+    const int rank = white ? 7 : 0;
+    const char rook = white ? 'R' : 'r';
+    bool kingMoved = white ? position.whiteKingMoved : position.blackKingMoved;
+    bool leftRookMoved = white ? position.whiteLeftRookMoved : position.blackLeftRookMoved;
+    bool rightRookMoved = white ? position.whiteRightRookMoved : position.blackRightRookMoved;
+    if (!kingMoved && r == rank && f == 4) {
+        if (!leftRookMoved && board[rank][0] == rook && board[rank][1] == '.' && board[rank][2] == '.' && board[rank][3] == '.') {
+            moves.push_back(encodeMove(rank, 4, rank, 2, 2)); // queenside, flag=2
+        }
+        if (!rightRookMoved && board[rank][7] == rook && board[rank][5] == '.' && board[rank][6] == '.') {
+            moves.push_back(encodeMove(rank, 4, rank, 6, 1)); // kingside, flag=1
+        }
+    }
+}
+
+template <bool white>
+static vector<int> generateMoves(const Position& position) {
+    PERF_SCOPE(perfMoveGeneration);
+    const auto& board = position.board;
+    vector<int> moves;
+    moves.reserve(50); // typical position has 30-40 legal moves
+
+    bool whiteKingFound = false;
+    bool blackKingFound = false;
+    for (int r = 0; r < 8; r++) {
+        for (int f = 0; f < 8; f++) {
+            if (board[r][f] == 'K') {
+                whiteKingFound = true;
+            }
+            if (board[r][f] == 'k') {
+                blackKingFound = true;
+            }
+        }
+    }
+
+    if (!whiteKingFound || !blackKingFound) {
+        return moves; // no legal moves if a king is dead
+    }
+
+    for (int r = 0; r < 8; r++) { // make every move for every piece of color
+        for (int f = 0; f < 8; f++) {
+            char piece = board[r][f];
+            if (!isOwnPiece<white>(piece)) continue;
+            switch (piece | 0x20) { // get moves for piece type, lowercase
+                case 'p': addPawnMoves<white>(position, r, f, moves); break;
+                case 'n': addKnightMoves<white>(position, r, f, moves); break;
+                case 'b': addSlidingMoves<white>(position, r, f, slidingDirections + 4, 4, moves); break;
+                case 'r': addSlidingMoves<white>(position, r, f, slidingDirections, 4, moves); break;
+                case 'q': addSlidingMoves<white>(position, r, f, slidingDirections, 8, moves); break;
+                case 'k': addKingMoves<white>(position, r, f, moves); break;
+            }
+        }
+    }
+    return moves;
+}
+
+vector<int> Position::generateMoves(bool whiteToMove) const {
+    return whiteToMove ? ::generateMoves<true>(*this) : ::generateMoves<false>(*this);
+}
+
+// Zobrist keys for a position hash: piece on square, side to move and castling rights
+struct ZobristKeys {
+    uint64_t pieces[12][64];
+    uint64_t blackToMove;
+    uint64_t castling[6];
+
+    ZobristKeys() {
+        uint64_t state = 0x5052495A4D5A4F42ULL;
+        auto next = [&]() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        for (int p = 0; p < 12; p++) {
+            for (int sq = 0; sq < 64; sq++) pieces[p][sq] = next();
+        }
+        blackToMove = next();
+        for (int i = 0; i < 6; i++) castling[i] = next();
+    }
+};
+
+static const ZobristKeys zobrist;
+
+// 0..5 white P N B R Q K, 6..11 black
+static inline int zobristPiece(char piece) {
+    return pieceToIndex(piece) + (isupper(piece) ? 0 : 6);
+}
+
+uint64_t Position::hash(bool whiteToMove) const {
+    uint64_t hash = whiteToMove ? 0 : zobrist.blackToMove;
+    for (int sq = 0; sq < 64; sq++) {
+        char piece = board[sq / 8][sq % 8];
+        if (piece != '.') hash ^= zobrist.pieces[zobristPiece(piece)][sq];
+    }
+    bool rights[6] = {whiteKingMoved, whiteLeftRookMoved, whiteRightRookMoved, blackKingMoved, blackLeftRookMoved, blackRightRookMoved};
+    for (int i = 0; i < 6; i++) {
+        if (rights[i]) hash ^= zobrist.castling[i];
+    }
+    return hash;
+}
+
+uint64_t Position::hashAfterMove(int move, bool whiteToMove, uint64_t hash) const {
+    int from = getFromRank(move) * 8 + getFromFile(move);
+    int to = getToRank(move) * 8 + getToFile(move);
+    char movingPiece = board[from / 8][from % 8];
+    char captured = board[to / 8][to % 8];
+
+    if (movingPiece != '.') {
+        hash ^= zobrist.pieces[zobristPiece(movingPiece)][from] ^ zobrist.pieces[zobristPiece(movingPiece)][to];
+    }
+    if (captured != '.') hash ^= zobrist.pieces[zobristPiece(captured)][to];
+
+    int flag = getMoveFlag(move);
+    int rank = whiteToMove ? 7 : 0;
+    if (flag != 0) { // castling also moves the rook
+        int rook = zobristPiece(whiteToMove ? 'R' : 'r');
+        hash ^= zobrist.pieces[rook][rank * 8 + (flag == 1 ? 7 : 0)] ^ zobrist.pieces[rook][rank * 8 + (flag == 1 ? 5 : 3)];
+    }
+    if (from / 8 == rank) { // castling rights given up, as in makeMove
+        int file = from % 8;
+        int right = file == 4 ? 0 : (file == 0 ? 1 : (file == 7 ? 2 : -1));
+        bool moved[6] = {whiteKingMoved, whiteLeftRookMoved, whiteRightRookMoved, blackKingMoved, blackLeftRookMoved, blackRightRookMoved};
+        if (right != -1 && !whiteToMove) right += 3;
+        if (right != -1 && !moved[right]) hash ^= zobrist.castling[right];
+    }
+    return hash ^ zobrist.blackToMove;
+}
+
+bool Position::isRepetition(uint64_t hash) const {
+    // the same side is to move every second ply
+    for (int i = (int)history.size() - 2; i >= 0; i -= 2) {
+        if (history[i] == hash) return true;
+    }
+    return false;
+}
+
+// Piece code of each board character for the evaluation tables, 0 for an empty square
+constexpr array<int, 128> makePieceCodes() {
+    array<int, 128> codes = {};
+    const char pieces[] = "PNBRQKpnbrqk";
+    for (int i = 0; i < 12; i++) codes[pieces[i]] = i + 1;
+    return codes;
+}
+
+constexpr array<int, 128> pieceCodes = makePieceCodes();
+
+static inline int pieceCode(char piece) {
+    return pieceCodes[piece & 0x7F];
+}
+
+// The default engine's heuristics for a piece on (i, j), from white's point of view
+constexpr int squareHeuristic(char piece, int i, int j) {
+    int evaluation = 0;
+    switch (piece) { // material evaluation
+        case 'P': evaluation += 10; break;
+        case 'N': evaluation += 30; break;
+        case 'B': evaluation += 30; break;
+        case 'R': evaluation += 50; break;
+        case 'Q': evaluation += 90; break;
+        case 'K': evaluation += 100000; break;
+
+        case 'p': evaluation -= 10; break;
+        case 'n': evaluation -= 30; break;
+        case 'b': evaluation -= 30; break;
+        case 'r': evaluation -= 50; break;
+        case 'q': evaluation -= 90; break;
+        case 'k': evaluation -= 100000; break;
+        default: break;
+    }
+
+    // minor piece development
+    if ((piece == 'N' || piece == 'B') && i < 6) evaluation += 2;
+    if ((piece == 'n' || piece == 'b') && i > 1) evaluation -= 2;
+
+    // centralized knights
+    bool center = i >= 2 && i <= 5 && j >= 2 && j <= 5;
+    if (piece == 'N' && center) evaluation += 2;
+    if (piece == 'n' && center) evaluation -= 2;
+
+    // advanced pawns
+    if (piece == 'P' && i < 5) evaluation += 1;
+    if (piece == 'p' && i > 2) evaluation -= 1;
+
+    // center control
+    bool middle = (i == 3 || i == 4) && (j == 3 || j == 4);
+    if (piece == 'P' && middle) evaluation += 5;
+    if (piece == 'p' && middle) evaluation -= 5;
+    return evaluation;
+}
+
+constexpr array<array<int, 64>, 13> makeDefaultSquareValues() {
+    array<array<int, 64>, 13> values = {};
+    const char pieces[] = ".PNBRQKpnbrqk";
+    for (int p = 0; p < 13; p++) {
+        for (int sq = 0; sq < 64; sq++) values[p][sq] = squareHeuristic(pieces[p], sq / 8, sq % 8);
+    }
+    return values;
+}
+
+constexpr array<array<int, 64>, 13> defaultSquareValues = makeDefaultSquareValues();
+
+Evaluator::Evaluator() {
+    for (int p = 0; p < 13; p++) {
+        for (int sq = 0; sq < 64; sq++) squareValues[p][sq] = defaultSquareValues[p][sq];
+    }
+    // defended pawns: a pawn with one of its own diagonally in front of it
+    memset(pairValues, 0, sizeof(pairValues));
+    int whitePawn = pieceCode('P');
+    int blackPawn = pieceCode('p');
+    pairValues[whitePawn][whitePawn][0][0] = pairValues[whitePawn][whitePawn][0][2] = 1;
+    pairValues[blackPawn][blackPawn][2][0] = pairValues[blackPawn][blackPawn][2][2] = -1;
+
+    int values[6] = {10, 30, 30, 50, 90, 0};
+    memcpy(material, values, sizeof(material));
+    castlingBonus = 0;
+    finish();
+}
+
+int pieceFeatures(char piece, int i, int j, Feature* out) {
+    int pieceIdx = pieceToIndex(piece);
+    if (pieceIdx == -1) return 0;
+    bool isWhite = isupper(piece);
+    int16_t multiplier = isWhite ? 1 : -1;
+    int rank = isWhite ? i : 7 - i;
+    out[0] = {(uint16_t)pieceIdx, multiplier};
+    out[1] = {(uint16_t)positionFeature(pieceIdx, rank, j), multiplier};
+    return 2;
+}
+
+Feature pairFeature(char piece, char neighbor, int dr, int df) {
+    int16_t multiplier = isupper(piece) ? 1 : -1;
+    return {(uint16_t)neighborFeature(pieceToIndex(piece), pieceToIndex(neighbor), dr, df), multiplier};
+}
+
+int pieceConstant(char piece) {
+    if (piece == 'K') return kingValue;
+    if (piece == 'k') return -kingValue;
+    return 0;
+}
+
+int squareFeatures(const Position& position, int i, int j, Feature* out) {
+    const auto& board = position.board;
+    int count = pieceFeatures(board[i][j], i, j, out);
+    if (count == 0) return 0;
+
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int df = -1; df <= 1; df++) {
+            if (dr == 0 && df == 0) continue; // skip center
+            int nr = i + dr;
+            int nf = j + df;
+            if (!inBounds(nr, nf) || board[nr][nf] == '.') continue;
+            out[count++] = pairFeature(board[i][j], board[nr][nf], dr, df);
+        }
+    }
+    return count;
+}
+
+int collectFeatures(const Position& position, Feature* out) {
+    int count = 0;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            if (position.board[i][j] != '.') count += squareFeatures(position, i, j, out + count);
+        }
+    }
+    return count;
+}
+
+int evaluationConstant(const Position& position) {
+    int constant = 0;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) constant += pieceConstant(position.board[i][j]);
+    }
+    if (position.whiteCastled) constant += castledValue;
+    if (position.blackCastled) constant -= castledValue;
+    return constant;
+}
+
+void extractFeatures(const Position& position, vector<Feature>& out) {
+    Feature features[maxFeatures];
+    int count = collectFeatures(position, features);
+
+    int coefficients[714] = {0};
+    uint16_t touched[maxFeatures];
+    int touchedCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (coefficients[features[i].index] == 0) touched[touchedCount++] = features[i].index;
+        coefficients[features[i].index] += features[i].coefficient;
+    }
+
+    // an index can be touched, cancel out to zero and be touched again
+    sort(touched, touched + touchedCount);
+    for (int i = 0; i < touchedCount; i++) {
+        if (i > 0 && touched[i] == touched[i - 1]) continue;
+        if (coefficients[touched[i]] != 0) out.push_back({touched[i], (int16_t)coefficients[touched[i]]});
+    }
+}
+
+// The tables hold the features of every piece on every square, so evaluate() gives the same
+// score as evaluationConstant() plus the weighted features
+Evaluator::Evaluator(const BotWeights& weights) {
+    const int* values = &weights.materialValues[0];
+    const char pieces[] = ".PNBRQKpnbrqk";
+    memset(squareValues, 0, sizeof(squareValues));
+    memset(pairValues, 0, sizeof(pairValues));
+    for (int p = 1; p < 13; p++) {
+        for (int sq = 0; sq < 64; sq++) {
+            Feature own[2];
+            int count = pieceFeatures(pieces[p], sq / 8, sq % 8, own);
+            int value = pieceConstant(pieces[p]);
+            for (int i = 0; i < count; i++) value += own[i].coefficient * values[own[i].index];
+            squareValues[p][sq] = value;
+        }
+        for (int n = 1; n < 13; n++) {
+            for (int dr = 0; dr < 3; dr++) {
+                for (int df = 0; df < 3; df++) {
+                    Feature pair = pairFeature(pieces[p], pieces[n], dr - 1, df - 1);
+                    pairValues[p][n][dr][df] = pair.coefficient * values[pair.index];
+                }
+            }
+        }
+    }
+    memcpy(material, weights.materialValues, sizeof(material));
+    castlingBonus = castledValue;
+    finish();
+}
+
+// FNV-1a over the tables, so evaluators with the same tables share a key
+void Evaluator::finish() {
+    key = 0xCBF29CE484222325ULL;
+    auto add = [&](const void* data, size_t length) {
+        const unsigned char* bytes = (const unsigned char*)data;
+        for (size_t i = 0; i < length; i++) {
+            key ^= bytes[i];
+            key *= 0x100000001B3ULL;
+        }
+    };
+    add(squareValues, sizeof(squareValues));
+    add(pairValues, sizeof(pairValues));
+    add(&castlingBonus, sizeof(castlingBonus));
+}
+
+int Evaluator::evaluate(const Position& position) const {
+    PERF_SCOPE(perfEvaluation);
+    const auto& board = position.board;
+    int evaluation = 0;
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            int p = pieceCode(board[i][j]);
+            if (p == 0) continue;
+            evaluation += squareValues[p][i * 8 + j];
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int df = -1; df <= 1; df++) {
+                    if ((dr == 0 && df == 0) || !inBounds(i + dr, j + df)) continue;
+                    evaluation += pairValues[p][pieceCode(board[i + dr][j + df])][dr + 1][df + 1];
+                }
+            }
+        }
+    }
+    if (position.whiteCastled) evaluation += castlingBonus;
+    if (position.blackCastled) evaluation -= castlingBonus;
+    return evaluation;
+}
+
+// Taking the piece on (r, f) off the board, or putting it there, moves the evaluation by exactly
+// this much: its own value and every pair it forms, computed while the piece stands on the square
+int Evaluator::pieceEvaluation(const Position& position, int r, int f) const {
+    const auto& board = position.board;
+    int p = pieceCode(board[r][f]);
+    if (p == 0) return 0;
+    int value = squareValues[p][r * 8 + f];
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int df = -1; df <= 1; df++) {
+            if ((dr == 0 && df == 0) || !inBounds(r + dr, f + df)) continue;
+            int n = pieceCode(board[r + dr][f + df]);
+            value += pairValues[p][n][dr + 1][df + 1] + pairValues[n][p][1 - dr][1 - df];
+        }
+    }
+    return value;
+}
+
+int Evaluator::evaluateAfterMove(Position& position, int move, bool whiteToMove, int evaluation) const {
+    auto& board = position.board;
+    int r = getFromRank(move);
+    int f = getFromFile(move);
+    int tr = getToRank(move);
+    int tf = getToFile(move);
+    int flag = getMoveFlag(move);
+
+    char movingPiece = board[r][f];
+    char captured = board[tr][tf];
+
+    evaluation -= pieceEvaluation(position, r, f);
+    board[r][f] = '.';
+    evaluation -= pieceEvaluation(position, tr, tf);
+    board[tr][tf] = movingPiece;
+    evaluation += pieceEvaluation(position, tr, tf);
+
+    if (flag != 0) { // castling also moves the rook
+        int rank = whiteToMove ? 7 : 0;
+        int rookFrom = flag == 1 ? 7 : 0;
+        int rookTo = flag == 1 ? 5 : 3;
+        char rook = board[rank][rookFrom];
+        evaluation -= pieceEvaluation(position, rank, rookFrom);
+        board[rank][rookFrom] = '.';
+        board[rank][rookTo] = rook;
+        evaluation += pieceEvaluation(position, rank, rookTo);
+        board[rank][rookTo] = '.';
+        board[rank][rookFrom] = rook;
+        if (whiteToMove && !position.whiteCastled) evaluation += castlingBonus;
+        if (!whiteToMove && !position.blackCastled) evaluation -= castlingBonus;
+    }
+
+    board[tr][tf] = captured;
+    board[r][f] = movingPiece;
+    return evaluation;
+}
+
+int Evaluator::exchangeValue(char piece) const {
+    if (tolower(piece) == 'k') return kingValue;
+    return material[pieceToIndex(piece)];
+}
+
+int Evaluator::largestMaterial() const {
+    return *max_element(material, material + 5);
+}
+
+// Least valuable piece of one side attacking square (tr, tf) on squares, false if there is none
+static bool leastValuableAttacker(const Evaluator& evaluator, char squares[8][8], int tr, int tf, bool white, int& ar, int& af) {
+    int best = INT32_MAX;
+    auto consider = [&](int r, int f, const char* kinds) {
+        if (!inBounds(r, f)) return;
+        char piece = squares[r][f];
+        if (piece == '.' || (isupper(piece) != 0) != white || !strchr(kinds, tolower(piece))) return;
+        int value = evaluator.exchangeValue(piece);
+        if (value < best) {
+            best = value;
+            ar = r;
+            af = f;
+        }
+    };
+
+    int pawnRank = white ? tr + 1 : tr - 1; // pawns capture towards the opponent
+    consider(pawnRank, tf - 1, "p");
+    consider(pawnRank, tf + 1, "p");
+    for (int i = 0; i < 8; i++) consider(tr + knightMoves[i][0], tf + knightMoves[i][1], "n");
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int df = -1; df <= 1; df++) {
+            if (dr == 0 && df == 0) continue;
+            consider(tr + dr, tf + df, "k");
+            // first piece along the ray, removed pieces uncover the ones behind them
+            int r = tr + dr;
+            int f = tf + df;
+            while (inBounds(r, f) && squares[r][f] == '.') {
+                r += dr;
+                f += df;
+            }
+            consider(r, f, dr != 0 && df != 0 ? "bq" : "rq");
+        }
+    }
+    return best != INT32_MAX;
+}
+
+// Material the side making a capture wins once both sides have recaptured on the square as long as it pays
+int Search::staticExchange(const Position& position, int move) const {
+    char squares[8][8];
+    memcpy(squares, position.board, sizeof(squares));
+    int tr = getToRank(move);
+    int tf = getToFile(move);
+    int r = getFromRank(move);
+    int f = getFromFile(move);
+    bool white = isupper(squares[r][f]) != 0;
+
+    int gain[32];
+    int depth = 0;
+    gain[0] = evaluator->exchangeValue(squares[tr][tf]);
+    while (true) {
+        // the piece that just captured stands on the square, the other side may take it
+        char attacker = squares[r][f];
+        squares[tr][tf] = attacker;
+        squares[r][f] = '.';
+        white = !white;
+        if (depth == 31 || !leastValuableAttacker(*evaluator, squares, tr, tf, white, r, f)) break;
+        depth++;
+        gain[depth] = evaluator->exchangeValue(attacker) - gain[depth - 1];
+    }
+    // either side stops capturing when continuing would lose more
+    while (depth > 0) {
+        gain[depth - 1] = -max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
+static int getMoveScore(const Position& position, int move) {
+    // Rank moves for better alpha-beta pruning
+    int score = 0;
+    char piece = position.board[getFromRank(move)][getFromFile(move)];
+    char captured = position.board[getToRank(move)][getToFile(move)];
+
+    // rank captures with MVV/LVA
+    if (captured != '.') {
+        int victimValue = 0;
+        switch (tolower(captured)) {
+            case 'p': victimValue = 1; break;
+            case 'n': victimValue = 3; break;
+            case 'b': victimValue = 3; break;
+            case 'r': victimValue = 5; break;
+            case 'q': victimValue = 9; break;
+            case 'k': victimValue = 100; break;
+        }
+
+        int attackerValue = 0;
+        switch (tolower(piece)) {
+            case 'p': attackerValue = 1; break;
+            case 'n': attackerValue = 3; break;
+            case 'b': attackerValue = 3; break;
+            case 'r': attackerValue = 5; break;
+            case 'q': attackerValue = 9; break;
+            case 'k': attackerValue = 100; break;
+        }
+
+        score = 1000 + (victimValue * 10) - attackerValue;
+    }
+
+    return score;
+}
+
+static void orderMoves(const Position& position, vector<int>& moves) {
+    PERF_SCOPE(perfOrdering);
+    // Sort moves by score descending, each move scored once rather than in every comparison
+    vector<pair<int, int>> scored(moves.size());
+    for (size_t i = 0; i < moves.size(); i++) scored[i] = {getMoveScore(position, moves[i]), moves[i]};
+    sort(scored.begin(), scored.end(), [](const pair<int, int>& a, const pair<int, int>& b) {
+        return a.first > b.first;
+    });
+    for (size_t i = 0; i < moves.size(); i++) moves[i] = scored[i].second;
+}
+
+// Evaluation cache: one 64 bit word per entry, the upper half of the key above the eval, so an entry
+// is written and read in a single access and a key that does not match the stored half is a miss.
+// 2^15 entries are 256 KB, well inside the L2 of the machines we run on.
+const int evalCacheBits = 15;
+
+Search::Search(const Evaluator& evaluator) : evaluator(&evaluator), cache(1 << evalCacheBits, 0) {}
+
+void Search::clearCache() {
+    fill(cache.begin(), cache.end(), 0);
+    cacheProbes = cacheHits = 0;
+}
+
+// Key of the position with this hash, castled flags included since they change the eval
+static inline uint64_t evalCacheKey(uint64_t hash, uint64_t salt, bool whiteHasCastled, bool blackHasCastled) {
+    return hash ^ salt ^ (whiteHasCastled ? zobrist.castling[0] * 3 : 0) ^ (blackHasCastled ? zobrist.castling[3] * 3 : 0);
+}
+
+// Eval after a search move from the cache, computed and stored on a miss
+int Search::cachedEvaluationAfterMove(Position& position, int move, bool whiteToMove, int evaluation, uint64_t childHash) {
+    PERF_SCOPE(perfEvaluation);
+    bool castles = getMoveFlag(move) != 0;
+    uint64_t key = evalCacheKey(childHash, cacheSalt, position.whiteCastled || (whiteToMove && castles),
+                                position.blackCastled || (!whiteToMove && castles));
+    uint64_t& entry = cache[key & ((1 << evalCacheBits) - 1)];
+    uint32_t check = key >> 32;
+    cacheProbes++;
+    if ((uint32_t)(entry >> 32) == check && entry != 0) {
+        cacheHits++;
+        return (int32_t)(uint32_t)entry;
+    }
+    int value = evaluator->evaluateAfterMove(position, move, whiteToMove, evaluation);
+    entry = (uint64_t)check << 32 | (uint32_t)value;
+    return value;
+}
+
+int Search::frontierMargin(int percent) const {
+    return evaluator->largestMaterial() * percent / 100; // the king's value is not material
+}
+
+// Negamax alpha-beta: scores, alpha and beta are from the side to move's point of view, currentEval
+// stays from white's as the evaluation is kept up to date move by move
+template <bool white>
+int Search::negamax(Position& position, int depth, int currentEval, int alpha, int beta, int ply) {
+    if (stopped) return 0;
+    const int sideEval = white ? currentEval : -currentEval;
+    if (depth == 0) { // base case
+        leaves++;
+        if (timed && (leaves & 1023) == 0 && chrono::steady_clock::now() > deadline) {
+            stopped = true;
+        }
+        return sideEval;
+    }
+
+    // mate distance pruning: at best the side to move takes the king now, at worst it loses its own next ply
+    int mateNow = mateScore - ply;
+    int matedNext = mateScore - ply - 1;
+    if (mateNow <= alpha) return mateNow;
+    if (-matedNext >= beta) return -matedNext;
+
+    nodes++;
+    if (depth == 3 && pruning.razor3 > 0) { // razoring
+        if (sideEval + frontierMargin(pruning.razor3) <= alpha) depth = 2;
+    }
+    int margin = 0; // futility margin, 0 unless the side to move is too far below alpha
+    int percent = depth == 1 ? pruning.futility1 : (depth == 2 ? pruning.futility2 : 0);
+    if (percent > 0) {
+        int candidate = frontierMargin(percent);
+        if (sideEval + candidate <= alpha) margin = candidate;
+    }
+
+    vector<int> moves = ::generateMoves<white>(position); // get moves
+    if (moves.empty()) return 0; // nothing to move is a stalemate
+    orderMoves(position, moves); // order moves for better time (in-place)
+
+    auto& board = position.board;
+    const char enemyKing = white ? 'k' : 'K';
+    int te = -10000000; // initial value
+    for (int move : moves) {
+        int tr = getToRank(move);
+        int tf = getToFile(move);
+        if (board[tr][tf] == enemyKing) return mateScore - ply; // nothing beats taking the king
+        // one ply from the leaves a losing capture is scored on the material it takes, the recapture is
+        // past the horizon, so skip it once another move has been searched
+        if (depth == 1 && te != -10000000 && board[tr][tf] != '.' && staticExchange(position, move) < 0) continue;
+        if (margin > 0) { // futility pruning, only material won could still reach alpha
+            int estimate = sideEval + margin + (board[tr][tf] == '.' ? 0 : evaluator->exchangeValue(board[tr][tf]));
+            if (estimate <= alpha) {
+                te = max(te, estimate);
+                continue;
+            }
+        }
+        uint64_t childHash = position.hashAfterMove(move, white, position.history.back());
+        int childEval = cachedEvaluationAfterMove(position, move, white, currentEval, childHash);
+        position.makeMove(move, white);
+        int evaluation = 0; // a repeated position is a draw, no need to search it again
+        if (!position.isRepetition(childHash)) {
+            position.history.push_back(childHash);
+            evaluation = -negamax<!white>(position, depth - 1, childEval, -beta, -alpha, ply + 1);
+            position.history.pop_back();
+        }
+        position.unmakeMove();
+        te = max(te, evaluation);
+        alpha = max(alpha, te); // update alpha
+        if (beta <= alpha) break; // prune remaining branches
+    }
+    return te; // return evaluation
+}
+
+template <bool white>
+int Search::searchRoot(Position& position, int depth, int currentEval, int firstMove) {
+    vector<int> moves = ::generateMoves<white>(position);
+    orderMoves(position, moves); // order moves for better time (in-place)
+    auto first = find(moves.begin(), moves.end(), firstMove);
+    if (first != moves.end()) rotate(moves.begin(), first, first + 1); // e.g. the best move one depth shallower
+
+    auto& board = position.board;
+    const char enemyKing = white ? 'k' : 'K';
+    int bestMove = 0;
+    int te = -10000000;
+    for (int move : moves) {
+        int tr = getToRank(move);
+        int tf = getToFile(move);
+        if (board[tr][tf] == enemyKing) return move; // taking the king ends the game
+        uint64_t childHash = position.hashAfterMove(move, white, position.history.back());
+        int childEval = cachedEvaluationAfterMove(position, move, white, currentEval, childHash);
+        position.makeMove(move, white);
+
+        int evaluation = 0; // repeating a position from the game is a draw
+        if (!position.isRepetition(childHash)) {
+            position.history.push_back(childHash);
+            // only a better move matters, so the best score so far bounds the window
+            evaluation = -negamax<!white>(position, depth - 1, childEval, -10000000, -te, 1);
+            position.history.pop_back();
+        }
+
+        position.unmakeMove();
+
+        if (evaluation > te) {
+            te = evaluation;
+            bestMove = move;
+        }
+
+        // with no king to take at the root, mating on our next move is the fastest there is
+        if (te >= mateScore - 2) break;
+        if (stopped) break;
+    }
+
+    return bestMove; // return best move
+}
+
+int Search::bestMove(Position& position, int depth, bool whiteToMove, int firstMove) {
+    uint64_t rootHash = position.hash(whiteToMove);
+    if (position.history.empty() || position.history.back() != rootHash) {
+        position.history.assign(1, rootHash); // no game history for this position, start from it
+    }
+    cacheSalt = evaluator->id() * 0x9E3779B97F4A7C15ULL; // entries of another evaluator stop matching
+
+    int currentEval = evaluator->evaluate(position);
+    return whiteToMove ? searchRoot<true>(position, depth, currentEval, firstMove)
+                       : searchRoot<false>(position, depth, currentEval, firstMove);
+}
+
+int Search::timedBestMove(Position& position, bool whiteToMove, double budget, double hardLimit, int maxDepth, int& depth) {
+    auto start = chrono::steady_clock::now();
+    int best = bestMove(position, 1, whiteToMove); // always have a move
+    depth = 1;
+
+    deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(hardLimit));
+    timed = true;
+    for (int d = 2; d <= maxDepth; d++) {
+        if (chrono::duration<double>(chrono::steady_clock::now() - start).count() > budget * 0.5) break;
+        int move = bestMove(position, d, whiteToMove, best);
+        if (stopped) break;
+        best = move;
+        depth = d;
+    }
+    timed = false;
+    stopped = false;
+    return best;
+}
+
+#ifdef PRISM_PERF
+// Time comes from the steady clock, the hardware events are one group led by cycles read with one
+// syscall and counting user space only. Without a PMU, e.g. in a VM, the report has time alone.
+static const char* perfNames[perfEventCount] = {"ms", "cycles", "instructions", "branch miss", "L1D miss", "LLC miss"};
+static thread_local bool perfActive = false; // only the thread that called perfOpen is counted
+static int perfSlot[perfEventCount];              // place of each event in a group read, -1 if it did not open
+static uint64_t perfTotals[perfPhases][perfEventCount];
+static long long perfCalls[perfPhases];
+static uint64_t perfOverhead[perfEventCount];     // of an empty scope, taken off every call
+static uint64_t perfFullOverhead[perfEventCount]; // the same with the parts of its reads outside the scope
+static uint64_t perfBase[perfEventCount];         // at perfReset
+static double perfScheduled = 1.0;                // share of the time the group was on the PMU
+
+#ifdef __linux__
+static int perfLeader = -1;
+
+static int perfEventOpen(uint32_t type, uint64_t config, int group) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group == -1; // the leader enables the whole group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+static void perfRead(uint64_t* values) {
+#ifdef __linux__
+    if (perfLeader != -1) {
+        uint64_t buffer[3 + perfEventCount]; // count, time enabled, time running, then the values
+        if (read(perfLeader, buffer, sizeof(buffer)) > 0) {
+            for (int e = 1; e < perfEventCount; e++) values[e] = perfSlot[e] == -1 ? 0 : buffer[3 + perfSlot[e]];
+            if (buffer[1] > 0) perfScheduled = (double)buffer[2] / buffer[1];
+        }
+    }
+#endif
+    values[0] = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PerfScope::PerfScope(PerfPhase phase) : phase(phase) {
+    if (perfActive) perfRead(start);
+}
+
+PerfScope::~PerfScope() {
+    if (!perfActive) return;
+    uint64_t end[perfEventCount] = {};
+    perfRead(end);
+    for (int e = 0; e < perfEventCount; e++) perfTotals[phase][e] += end[e] - start[e];
+    perfCalls[phase]++;
+}
+
+void perfReset() {
+    if (!perfActive) return;
+    memset(perfTotals, 0, sizeof(perfTotals));
+    memset(perfCalls, 0, sizeof(perfCalls));
+    memset(perfBase, 0, sizeof(perfBase));
+    perfRead(perfBase);
+}
+
+bool perfOpen() {
+    if (perfActive) return true;
+#ifdef __linux__
+    perfSlot[0] = -1; // the clock is not part of the group
+    for (int e = 1; e < perfEventCount; e++) perfSlot[e] = -1;
+    perfLeader = perfEventOpen(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (perfLeader == -1) {
+        printf("No hardware counters (%s), timing phases only\n", strerror(errno));
+    } else {
+        const uint64_t cacheReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const uint32_t types[perfEventCount] = {0, 0, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE};
+        const uint64_t configs[perfEventCount] = {0, 0, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+                                                  PERF_COUNT_HW_CACHE_L1D | cacheReadMiss, PERF_COUNT_HW_CACHE_LL | cacheReadMiss};
+        int members = 1;
+        perfSlot[1] = 0;
+        for (int e = 2; e < perfEventCount; e++) { // an event the CPU lacks is left out of the report
+            perfSlot[e] = perfEventOpen(types[e], configs[e], perfLeader) == -1 ? -1 : members++;
+        }
+        ioctl(perfLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    perfActive = true;
+
+    // cost of the reads themselves, from empty scopes
+    perfReset();
+    const int samples = 100000;
+    for (int i = 0; i < samples; i++) PerfScope scope(perfMoveGeneration);
+    uint64_t now[perfEventCount] = {};
+    perfRead(now);
+    for (int e = 0; e < perfEventCount; e++) {
+        perfOverhead[e] = perfTotals[perfMoveGeneration][e] / samples;
+        perfFullOverhead[e] = (now[e] - perfBase[e]) / samples;
+    }
+    perfReset();
+    return true;
+#else
+    printf("Performance counters need perf_event_open, which is Linux only\n");
+    return false;
+#endif
+}
+
+void perfReport(const char* title) {
+    if (!perfActive) return;
+    uint64_t now[perfEventCount] = {};
+    perfRead(now);
+
+    static const char* phaseNames[perfPhases + 2] = {"movegen", "ordering", "evaluation", "make/unmake", "other", "total"};
+    uint64_t rows[perfPhases + 2][perfEventCount];
+    long long calls[perfPhases + 2] = {};
+    for (int e = 0; e < perfEventCount; e++) {
+        uint64_t overhead = 0;
+        uint64_t claimed = 0;
+        for (int p = 0; p < perfPhases; p++) {
+            uint64_t cost = perfCalls[p] * perfOverhead[e];
+            overhead += perfCalls[p] * perfFullOverhead[e];
+            rows[p][e] = perfTotals[p][e] - min(perfTotals[p][e], cost);
+            claimed += rows[p][e];
+        }
+        uint64_t total = now[e] - perfBase[e];
+        rows[perfPhases + 1][e] = total - min(total, overhead);
+        rows[perfPhases][e] = rows[perfPhases + 1][e] - min(rows[perfPhases + 1][e], claimed);
+    }
+    for (int p = 0; p < perfPhases; p++) {
+        calls[p] = perfCalls[p];
+        calls[perfPhases + 1] += perfCalls[p];
+    }
+
+    printf("Counters, %s\n", title);
+    printf("%-12s %12s", "", "calls");
+    for (int e = 0; e < perfEventCount; e++) printf(" %14s", perfNames[e]);
+    printf(" %6s\n", "IPC");
+    for (int p = 0; p < perfPhases + 2; p++) {
+        printf("%-12s %12lld", phaseNames[p], calls[p]);
+        printf(" %14.1f", rows[p][0] / 1e6);
+        for (int e = 1; e < perfEventCount; e++) {
+            if (perfSlot[e] == -1) printf(" %14s", "-");
+            else printf(" %14llu", (unsigned long long)rows[p][e]);
+        }
+        if (perfSlot[1] != -1 && perfSlot[2] != -1 && rows[p][1] > 0) printf(" %6.2f\n", (double)rows[p][2] / rows[p][1]);
+        else printf(" %6s\n", "-");
+    }
+    if (perfScheduled < 0.99) printf("The group was on the PMU %.0f%% of the time, counts are partial\n", 100.0 * perfScheduled);
+}
+#endif
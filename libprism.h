@@ -0,0 +1,237 @@
+/*
+ * PRISM Engine V0.7
+ * Engine library: positions, evaluators and searches as objects
+ * Any number of each can live in one process, a search only touches the position it is given
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#ifndef LIBPRISM_H
+#define LIBPRISM_H
+
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Move encoding: (flag << 16) | (r << 12) | (f << 8) | (tr << 4) | tf
+// flag: 0 = normal, 1 = kingside castle, 2 = queenside castle
+inline int encodeMove(int r, int f, int tr, int tf, int flag = 0) {
+    return (flag << 16) | (r << 12) | (f << 8) | (tr << 4) | tf;
+}
+
+inline int getFromRank(int move) {
+    return (move >> 12) & 0xF;
+}
+
+inline int getFromFile(int move) {
+    return (move >> 8) & 0xF;
+}
+
+inline int getToRank(int move) {
+    return (move >> 4) & 0xF;
+}
+
+inline int getToFile(int move) {
+    return move & 0xF;
+}
+
+inline int getMoveFlag(int move) {
+    return (move >> 16) & 0xF;
+}
+
+inline bool inBounds(int r, int f) {
+    return r >= 0 && r < 8 && f >= 0 && f < 8;
+}
+
+// Convert piece character to index (0-5)
+inline int pieceToIndex(char piece) {
+    switch (tolower(piece)) {
+        case 'p': return 0;
+        case 'n': return 1;
+        case 'b': return 2;
+        case 'r': return 3;
+        case 'q': return 4;
+        case 'k': return 5;
+        default: return -1;
+    }
+}
+
+// Evaluation weights loaded from a bot file
+// types 0 = P, 1 = N, 2 = B, 3 = R, 4 = Q, 5 = K
+struct BotWeights {
+    int materialValues[6];       // Material values
+    int positionPST[6][8][8];    // Positional piece square table
+    int neighborPST[6][6][3][3]; // Neighbor piece square table
+};
+
+static_assert(sizeof(BotWeights) == 714 * sizeof(int), "bot files hold 714 values in this order");
+
+// Capturing the king ends the game: scored mateScore - ply for the side that takes it, so a faster win scores higher
+const int mateScore = 1000000; // above any evaluation with both kings on the board
+
+const int kingValue = 100000;   // added for each king on top of its weights, losing the king loses the game
+const int castledValue = 10;    // for a side that has castled
+
+// A bot's evaluation as features: a position is worth evaluationConstant() plus the sum of
+// coefficient * value over its features, with values indexed in bot file order
+struct Feature {
+    uint16_t index;       // position in the bot file
+    int16_t coefficient;  // white pieces count +1, black pieces -1
+};
+
+const int maxFeatures = 640; // 64 squares with two own terms and eight neighbor pairs each
+
+inline int positionFeature(int pieceIdx, int rank, int f) {
+    return 6 + (pieceIdx * 8 + rank) * 8 + f;
+}
+
+inline int neighborFeature(int pieceIdx, int neighborIdx, int dr, int df) {
+    return 390 + ((pieceIdx * 6 + neighborIdx) * 3 + dr + 1) * 3 + df + 1;
+}
+
+// What makeMove changes beyond the move itself, enough for unmakeMove to take it back
+struct MoveUndo {
+    int move;
+    char captured;
+    uint8_t castling; // moved flags in hash order, then white and black castled
+};
+
+// A board with its castling state; row 0 is black's back rank, uppercase pieces are white
+class Position {
+    public:
+        char board[8][8];
+        bool whiteKingMoved = false, blackKingMoved = false, whiteLeftRookMoved = false,
+            whiteRightRookMoved = false, blackLeftRookMoved = false, blackRightRookMoved = false;
+        bool whiteCastled = false;
+        bool blackCastled = false;
+        std::vector<uint64_t> history; // hashes of the positions played, then of the line a search is looking at
+        std::vector<MoveUndo> undoStack; // one record per move made and not taken back
+
+        Position();
+
+        void reset();                                       // starting position with full castling rights
+        bool setFromFEN(const std::string& placement);      // piece placement field of a FEN, false if malformed
+        void makeMove(int move, bool whiteToMove);          // play a move, the king or a rook leaving home gives up castling
+        void unmakeMove();                                  // take back the last move made
+        std::vector<int> generateMoves(bool whiteToMove) const; // none once a king has been taken
+
+        uint64_t hash(bool whiteToMove) const;
+        uint64_t hashAfterMove(int move, bool whiteToMove, uint64_t hash) const; // from the hash before the move
+        bool isRepetition(uint64_t hash) const; // already in the history with the same side to move
+
+    private:
+        uint8_t castlingState() const;
+        void setCastlingState(uint8_t state);
+};
+
+// Own terms of a piece on (i, j): material and position
+int pieceFeatures(char piece, int i, int j, Feature* out);
+// Term of a piece with a neighbor at (i + dr, j + df)
+Feature pairFeature(char piece, char neighbor, int dr, int df);
+// What a piece adds beyond the weights
+int pieceConstant(char piece);
+
+int squareFeatures(const Position& position, int i, int j, Feature* out); // piece on (i, j) and its neighbor pairs
+int collectFeatures(const Position& position, Feature* out);    // every term, unmerged with coefficients of +-1
+int evaluationConstant(const Position& position);               // the terms that are not weights
+void extractFeatures(const Position& position, std::vector<Feature>& out); // repeated indices merged
+
+// Static evaluation from white's point of view: a value per piece on each square plus one per
+// pair of adjacent pieces, either from a bot's weights or the default engine's own heuristics
+class Evaluator {
+    public:
+        Evaluator();                                // the default engine's hand-written evaluation
+        explicit Evaluator(const BotWeights& weights);
+
+        int evaluate(const Position& position) const;
+        // Evaluation after a move from the evaluation before it; the board is left as it was
+        int evaluateAfterMove(Position& position, int move, bool whiteToMove, int evaluation) const;
+        int exchangeValue(char piece) const; // material of a piece, the king is worth the game
+        int largestMaterial() const;         // of the pieces other than the king
+        uint64_t id() const { return key; }  // identifies the tables by content
+
+    private:
+        int squareValues[13][64];    // by piece code, 0 = empty, 1..6 white P N B R Q K, 7..12 black
+        int pairValues[13][13][3][3]; // piece with a neighbor at (dr + 1, df + 1)
+        int material[6];
+        int castlingBonus;
+        uint64_t key;
+
+        void finish();
+        int pieceEvaluation(const Position& position, int r, int f) const;
+};
+
+// Frontier pruning margins in percent of the evaluator's largest material value, 0 turns one off
+struct FrontierPruning {
+    int futility1 = 300; // one ply from the leaves, quiet moves that can't reach the bound are skipped
+    int futility2 = 600; // two plies from the leaves, the same with a wider margin
+    int razor3 = 900;    // three plies from the leaves, a node this far below the bound searches one ply less
+};
+
+// Alpha-beta search with one evaluator and its own evaluation cache
+class Search {
+    public:
+        explicit Search(const Evaluator& evaluator);
+
+        FrontierPruning pruning;
+        long long nodes = 0;       // interior nodes searched
+        long long leaves = 0;      // positions evaluated at the leaves
+        long long cacheProbes = 0;
+        long long cacheHits = 0;
+
+        // Best move for the side to move searched to depth, firstMove is searched first if it is legal
+        int bestMove(Position& position, int depth, bool whiteToMove, int firstMove = 0);
+        // Iterative deepening: each finished depth replaces the move, no new depth starts past half the
+        // budget since it would likely not finish, and a depth still running at hardLimit is abandoned
+        int timedBestMove(Position& position, bool whiteToMove, double budget, double hardLimit, int maxDepth, int& depth);
+        void clearCache();
+
+    private:
+        const Evaluator* evaluator;
+        std::vector<uint64_t> cache;
+        uint64_t cacheSalt = 0;
+        bool timed = false;
+        bool stopped = false;
+        std::chrono::steady_clock::time_point deadline;
+
+        int cachedEvaluationAfterMove(Position& position, int move, bool whiteToMove, int evaluation, uint64_t childHash);
+        int staticExchange(const Position& position, int move) const;
+        int frontierMargin(int percent) const;
+        template <bool white> int negamax(Position& position, int depth, int currentEval, int alpha, int beta, int ply);
+        template <bool white> int searchRoot(Position& position, int depth, int currentEval, int firstMove);
+};
+
+// Hardware counters per search phase, compiled in with PRISM_PERF (make PERF=1) and read with
+// perf_event_open on Linux. Without it the scopes are empty and the calls do nothing.
+enum PerfPhase { perfMoveGeneration, perfOrdering, perfEvaluation, perfMakeUnmake, perfPhases };
+
+#ifdef PRISM_PERF
+const int perfEventCount = 6; // time, cycles, instructions, branch misses, L1D and LLC read misses
+
+bool perfOpen();                     // counters of the calling thread, false if none could be opened
+void perfReset();                    // zero the totals, the report's total counts from here
+void perfReport(const char* title);  // totals per phase since perfReset, the rest of the time as other
+
+// Counts from construction to destruction go to the phase, scopes must not nest
+class PerfScope {
+    public:
+        explicit PerfScope(PerfPhase phase);
+        ~PerfScope();
+
+    private:
+        PerfPhase phase;
+        uint64_t start[perfEventCount];
+};
+
+#define PERF_SCOPE(phase) PerfScope perfScope(phase)
+#else
+inline bool perfOpen() { return false; }
+inline void perfReset() {}
+inline void perfReport(const char*) {}
+
+#define PERF_SCOPE(phase)
+#endif
+
+#endif
@@ -3,6 +3,15 @@
 #include <string>
 #include <random>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+
+#include "prism-mutation.h"
 
 using namespace std;
 
@@ -14,127 +23,193 @@ vector<int> readBotFile(const string& filename) {
         cout << "Error: Could not open file " << filename << "\n";
         return values;
     }
-    
+
     int value;
     while (inFile >> value) {
         values.push_back(value);
     }
-    
+
     inFile.close();
     return values;
 }
 
-// Write bot file with given values
-void writeBotFile(const string& filename, const vector<int>& values) {
-    ofstream outFile(filename);
-    if (!outFile) {
-        cout << "Error: Could not create file " << filename << "\n";
-        return;
-    }
-    
-    // Write material values (6 values)
-    for (int i = 0; i < 6 && i < values.size(); i++) {
-        outFile << values[i];
-        if (i < 5) outFile << " ";
-    }
-    outFile << "\n";
-    
-    // Write position PST (next 384 values: 48 groups of 8)
-    int count = 0;
-    for (int i = 6; i < 390 && i < values.size(); i++) {
-        outFile << values[i];
-        count++;
-        if (count % 8 == 0) {
-            outFile << "\n";
-        } else {
-            outFile << " ";
-        }
+const int maxValueLength = 11; // any int, "-2147483648"
+
+// Format bot values into buf in the bot file layout, returns the length written or 0 if a value did not fit
+// buf needs room for botValueCount values of up to maxValueLength characters plus a separator each
+size_t formatBotFile(const int* values, char* buf) {
+    char* out = buf;
+
+    // Material values (6 values)
+    for (int i = 0; i < 6; i++) {
+        to_chars_result result = to_chars(out, out + maxValueLength, values[i]);
+        if (result.ec != errc()) return 0;
+        out = result.ptr;
+        *out++ = i < 5 ? ' ' : '\n';
     }
-    
-    // Write neighbor PST (next 324 values: 54 groups of 6)
-    count = 0;
-    for (int i = 390; i < values.size(); i++) {
-        outFile << values[i];
-        count++;
-        if (count % 6 == 0) {
-            outFile << "\n";
-        } else {
-            outFile << " ";
-        }
+
+    // Position PST (next 384 values: 48 groups of 8)
+    for (int i = 0; i < 384; i++) {
+        to_chars_result result = to_chars(out, out + maxValueLength, values[6 + i]);
+        if (result.ec != errc()) return 0;
+        out = result.ptr;
+        *out++ = (i + 1) % 8 == 0 ? '\n' : ' ';
+    }
+
+    // Neighbor PST (next 324 values: 54 groups of 6)
+    for (int i = 0; i < 324; i++) {
+        to_chars_result result = to_chars(out, out + maxValueLength, values[390 + i]);
+        if (result.ec != errc()) return 0;
+        out = result.ptr;
+        *out++ = (i + 1) % 6 == 0 ? '\n' : ' ';
+    }
+
+    return out - buf;
+}
+
+enum class Crossover { Uniform, Blend };
+
+// Settings shared by every child
+struct BatchConfig {
+    double mutationFactor = 0.0;
+    Crossover crossover = Crossover::Uniform;
+    uint64_t seed = 0;
+};
+
+// Build one child: crossover between all parents, then the +-50 mutation with clamping
+void generateChild(const vector<vector<int>>& parents, const BatchConfig& config, uint64_t childIndex, int* child) {
+    FastRandom rng(config.seed ^ (childIndex * 0xD1B54A32D192ED03ULL));
+
+    if (parents.size() == 1) {
+        copy(parents[0].begin(), parents[0].end(), child);
+    } else if (config.crossover == Crossover::Uniform) {
+        uniformCrossover(parents, parents.size(), child, rng);
+    } else {
+        blendCrossover(parents, parents.size(), child, rng);
     }
-    
-    outFile.close();
+    mutateBotValues(child, config.mutationFactor, rng);
 }
 
-// Generate mutated bot
-void generateMutatedBot(const string& inputFile, const string& outputFile, double mutationFactor) {
-    vector<int> originalValues = readBotFile(inputFile);
-    if (originalValues.empty()) {
-        return;
-    }
-    
-    random_device rd;
-    mt19937 gen(rd());
-    
-    vector<int> mutatedValues = originalValues;
-    
-    for (int i = 0; i < mutatedValues.size(); i++) {
-        uniform_real_distribution<> mutateChance(0.0, 1.0);
-        
-        if (mutateChance(gen) < mutationFactor) {
-            // Apply mutation: add/subtract a random value
-            uniform_int_distribution<> mutationAmount(-50, 50);
-            mutatedValues[i] += mutationAmount(gen);
-            
-            // Clamp values in range
-            if (i < 6) {
-                // Material values: keep between 1 and 1000
-                mutatedValues[i] = max(1, min(1000, mutatedValues[i]));
-            } else {
-                // PST values: keep between -200 and 200
-                mutatedValues[i] = max(-200, min(200, mutatedValues[i]));
-            }
+// Generate and write children [first, last) with stride, each straight from a stack buffer
+void generateBatch(const vector<vector<int>>& parents, const BatchConfig& config, const string& outputDir,
+                   int first, int last, int stride, atomic<int>& failures) {
+    int child[botValueCount];
+    char text[botValueCount * (maxValueLength + 1)];
+
+    for (int i = first; i < last; i += stride) {
+        generateChild(parents, config, i, child);
+        size_t length = formatBotFile(child, text);
+
+        string filename = outputDir + "/bot_" + to_string(i) + ".txt";
+        FILE* outFile = fopen(filename.c_str(), "wb");
+        if (length == 0 || !outFile || fwrite(text, 1, length, outFile) != length) {
+            failures++;
         }
+        if (outFile) fclose(outFile);
     }
-    
-    writeBotFile(outputFile, mutatedValues);
-    cout << "Created: " << outputFile << "\n";
 }
 
 int main(int argc, char* argv[]) {
     cout.setf(ios::unitbuf); // Enable unbuffered output
-    
-    if (argc != 5) {
-        cout << "Usage: " << argv[0] << " <input_bot> <quantity> <mutation_factor> <output_directory>\n";
+
+    if (argc < 5) {
+        cout << "Usage: " << argv[0] << " <input_bot> <quantity> <mutation_factor> <output_directory> [options]\n";
+        cout << "Options:\n";
+        cout << "  --with <bot>           another parent for crossover, repeatable\n";
+        cout << "  --crossover <type>     uniform or blend (default uniform)\n";
+        cout << "  --threads <n>          worker threads (default: all cores)\n";
+        cout << "  --seed <n>             random seed (default random)\n";
         return 1;
     }
-    
+
     string inputBot = argv[1];
     int quantity = stoi(argv[2]);
     double mutationFactor = stod(argv[3]);
     string outputDir = argv[4];
-    
+
+    vector<string> parentFiles = {inputBot};
+    BatchConfig config;
+    config.mutationFactor = mutationFactor;
+    config.seed = ((uint64_t)random_device()() << 32) | random_device()();
+    int threadCount = max(1u, thread::hardware_concurrency());
+
+    for (int i = 5; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--with" && hasValue) {
+            parentFiles.push_back(argv[++i]);
+        } else if (arg == "--crossover" && hasValue) {
+            string type = argv[++i];
+            if (type == "uniform") {
+                config.crossover = Crossover::Uniform;
+            } else if (type == "blend") {
+                config.crossover = Crossover::Blend;
+            } else {
+                cout << "Error: Crossover must be uniform or blend\n";
+                return 1;
+            }
+        } else if (arg == "--threads" && hasValue) {
+            threadCount = max(1, stoi(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = stoull(argv[++i]);
+        } else {
+            cout << "Error: Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
     // check factor
     if (mutationFactor < 0.0 || mutationFactor > 1.0) {
         cout << "Error: Mutation factor must be between 0.0 and 1.0\n";
         return 1;
     }
-    
+
     // Remove trailing slash if present
     if (outputDir.back() == '/') {
         outputDir.pop_back();
     }
-    
-    cout << "Generating " << quantity << " mutated bots from " << inputBot << " with factor " << mutationFactor << "\n";
+
+    // parents are read once for the whole batch
+    vector<vector<int>> parents;
+    for (const string& file : parentFiles) {
+        vector<int> values = readBotFile(file);
+        if ((int)values.size() != botValueCount) {
+            cout << "Error: " << file << " holds " << values.size() << " values, expected " << botValueCount << "\n";
+            return 1;
+        }
+        parents.push_back(values);
+    }
+
+    cout << "Generating " << quantity << " mutated bots from " << inputBot;
+    if (parents.size() > 1) {
+        cout << " and " << parents.size() - 1 << " more parents (" << (config.crossover == Crossover::Blend ? "blend" : "uniform") << " crossover)";
+    }
+    cout << " with factor " << mutationFactor << "\n";
     cout.flush();
-    
-    for (int i = 1; i < quantity; i++) {
-        string filename = outputDir + "/bot_" + to_string(i) + ".txt";
-        generateMutatedBot(inputBot, filename, mutationFactor);
+
+    auto start = chrono::steady_clock::now();
+
+    // bot_0 stays the input bot, children are bot_1 .. bot_<quantity - 1>
+    threadCount = max(1, min(threadCount, quantity - 1));
+    atomic<int> failures(0);
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back(generateBatch, cref(parents), cref(config), cref(outputDir), 1 + t, quantity, threadCount, ref(failures));
+    }
+    for (thread& worker : threads) {
+        worker.join();
+    }
+
+    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    if (failures > 0) {
+        cout << "Error: Could not write " << failures << " bots in " << outputDir << "/\n";
+        return 1;
     }
-    
-    cout << "Successfully generated " << quantity - 1 << " mutated bots in " << outputDir << "/\n";
+
+    cout << "Successfully generated " << quantity - 1 << " mutated bots in " << outputDir << "/ ("
+         << elapsed << " ms, " << threadCount << " threads)\n";
     cout.flush();
-    
+
     return 0;
-}
\ No newline at end of file
+}
@@ -5,6 +5,8 @@
  * (C) 2025 Tommy Ciccone All Rights Reserved.
 */
 
+#include "libprism.h"
+
 #include <chrono>
 #include <iostream>
 #include <string>
@@ -31,35 +33,16 @@ class Timer {
 
 int engineDepth = 5;
 
-bool whiteKingMoved = 0, blackKingMoved = 0, whiteLeftRookMoved = 0, 
-    whiteRightRookMoved = 0, blackLeftRookMoved = 0, blackRightRookMoved = 0;
-
-bool castled = false;
-
-int positionsEvaluated = 0;
-char board[8][8]; // 8x8 chess board
-
-void initializeBoard() { // place default pieces on board
-    string blackPieces = "rnbqkbnr";
-    string whitePieces = "RNBQKBNR";
-
-    for (int i = 0; i < 8; i++) {
-        board[0][i] = blackPieces[i];
-        board[1][i] = 'p';
-        board[6][i] = 'P';
-        board[7][i] = whitePieces[i];
-        for (int j = 2; j < 6; j++) {
-            board[j][i] = '.';
-        }
-    }
-}
+Position position;
+Evaluator evaluator; // the hand-written evaluation
+Search engine(evaluator);
 
 void printBoard() { // print board to console
     cout << "\n";
     for (int i = 0; i < 8; i++) {
         cout << "\033[90m" << 8 - i << " \033[0m";  // rank
         for (int j = 0; j < 8; j++) {
-            char piece = board[i][j];
+            char piece = position.board[i][j];
             string unicodePiece = ".";
             
             // Unicode chess pieces
@@ -85,466 +68,6 @@ void printBoard() { // print board to console
     cout << "\033[90m  a b c d e f g h\n\n\033[0m"; // file
 }
 
-// Move encoding: (flag << 16) | (r << 12) | (f << 8) | (tr << 4) | tf
-// flag: 0 = normal, 1 = kingside castle, 2 = queenside castle
-inline int encodeMove(int r, int f, int tr, int tf, int flag = 0) {
-    return (flag << 16) | (r << 12) | (f << 8) | (tr << 4) | tf;
-}
-
-inline int getFromRank(int move) {
-    return (move >> 12) & 0xF;
-}
-
-inline int getFromFile(int move) {
-    return (move >> 8) & 0xF;
-}
-
-inline int getToRank(int move) {
-    return (move >> 4) & 0xF;
-}
-
-inline int getToFile(int move) {
-    return move & 0xF;
-}
-
-inline int getMoveFlag(int move) {
-    return (move >> 16) & 0xF;
-}
-
-int immediateEvaluation() {
-    int evaluation = 0;
-    bool whiteWins = true;
-    bool blackWins = true;
-    char piece;
-
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            piece = board[i][j];
-
-            switch (piece) { // material evaluation
-                case 'P': evaluation += 10; break;
-                case 'N': evaluation += 30; break;
-                case 'B': evaluation += 30; break;
-                case 'R': evaluation += 50; break;
-                case 'Q': evaluation += 90; break;
-                case 'K': evaluation += 100000; whiteWins = false; break;
-
-                case 'p': evaluation -= 10; break;
-                case 'n': evaluation -= 30; break;
-                case 'b': evaluation -= 30; break;
-                case 'r': evaluation -= 50; break;
-                case 'q': evaluation -= 90; break;
-                case 'k': evaluation -= 100000; blackWins = false; break;
-                default: break;
-            }
-
-            if (castled) {
-                evaluation -= 4; // bonus/penalty for castling (kept as original)
-            }
-
-            // minor piece development
-            if (piece == 'N' || piece == 'B') {
-                if (i < 6) evaluation += 2;
-            }
-            if (piece == 'n' || piece == 'b') {
-                if (i > 1) evaluation -= 2;
-            }
-
-            // centralized knights
-            if (piece == 'N' && (i >= 2 && i <= 5 && j >= 2 && j <= 5)) evaluation += 2;
-            if (piece == 'n' && (i >= 2 && i <= 5 && j >= 2 && j <= 5)) evaluation -= 2;
-
-            // defended pawns
-            if (piece == 'P' && i > 0) {
-                if (j > 0 && board[i-1][j-1] == 'P') evaluation += 1;
-                if (j < 7 && board[i-1][j+1] == 'P') evaluation += 1;
-            }
-            if (piece == 'p' && i < 7) {
-                if (j > 0 && board[i+1][j-1] == 'p') evaluation -= 1;
-                if (j < 7 && board[i+1][j+1] == 'p') evaluation -= 1;
-            }
-
-            // advanced pawns
-            if (piece == 'P' && i < 5) evaluation += 1;
-            if (piece == 'p' && i > 2) evaluation -= 1;
-
-            // center control
-            if (piece == 'P') {
-                if ((i == 3 || i == 4) && (j == 3 || j == 4)) {
-                    evaluation += 5;
-                }
-            }
-            if (piece == 'p') {
-                if ((i == 3 || i == 4) && (j == 3 || j == 4)) {
-                    evaluation -= 5;
-                }
-            }
-        }
-    }
-    positionsEvaluated++;
-    return evaluation;
-}
-
-bool inBounds(int r, int f) { // check if a target square is on the board
-    return r >= 0 && r < 8 && f >= 0 && f < 8;
-}
-
-vector<int> enumeratePawnMoves(int r, int f, char piece) { // list all possible pawn moves for a given pawn
-    vector<int> moves;
-    moves.reserve(4);
-    int direction = 0;
-    switch (piece) { // get forwards direction of pawn
-        case 'P': direction = -1; break;
-        case 'p': direction = 1; break;
-    }
-
-    if (inBounds(r + direction, f) && board[r + direction][f] == '.') { // check if square in front is empty
-        moves.push_back(encodeMove(r, f, r + direction, f));
-        if ((piece == 'P' && r == 6) || (piece == 'p' && r == 1)) { // check if pawn is on starting square
-            if (inBounds(r + 2 * direction, f) && board[r + 2 * direction][f] == '.') { // then check two ahead
-                moves.push_back(encodeMove(r, f, r + 2*direction, f));
-            }
-        }
-    }
-
-    // captures
-    if (inBounds(r + direction, f - 1) && islower(board[r + direction][f - 1]) != islower(piece) && board[r + direction][f - 1] != '.') {
-        moves.push_back(encodeMove(r, f, r + direction, f - 1));
-    }
-
-    if (inBounds(r + direction, f + 1) && islower(board[r + direction][f + 1]) != islower(piece) && board[r + direction][f + 1] != '.') {
-        moves.push_back(encodeMove(r, f, r + direction, f + 1));
-    }
-    return moves;
-}
-
-vector<int> enumerateKnightMoves(int r, int f, char piece) { // list all possible knight moves for a given knight
-    vector<int> moves;
-    moves.reserve(8);
-    int knightMoves[8][2] = {{2, -1}, {2, 1}, {-2, -1}, {-2, 1}, {1, -2}, {1, 2}, {-1, -2}, {-1, 2}}; // knight move patterns
-
-    for (int i = 0; i < 8; i++) { // check each knight move pattern, capture or open square
-        int tr = r + knightMoves[i][0];
-        int tf = f + knightMoves[i][1];
-        if (inBounds(tr, tf)) {
-            if (board[tr][tf] == '.' || islower(board[tr][tf]) != islower(piece)) {
-                moves.push_back(encodeMove(r, f, tr, tf));
-            }
-        }
-    }
-    return moves;
-}
-
-vector<int> enumerateBishopMoves(int r, int f, char piece) { // list all possible bishop moves for a given bishop
-    vector<int> moves;
-    moves.reserve(13);
-    int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // bishop move directions
-    for (int i = 0; i < 4; i++) {
-        int dr = bishopDirections[i][0];
-        int df = bishopDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(encodeMove(r, f, tr, tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(encodeMove(r, f, tr, tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
-    }
-    return moves;
-}
-
-vector<int> enumerateRookMoves(int r, int f, char piece) { // list all possible rook moves for a given rook
-    vector<int> moves;
-    moves.reserve(14);
-    int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}; // rook move directions
-    for (int i = 0; i < 4; i++) {
-        int dr = rookDirections[i][0];
-        int df = rookDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(encodeMove(r, f, tr, tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(encodeMove(r, f, tr, tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
-    }
-    return moves;
-}
-
-vector<int> enumerateQueenMoves(int r, int f, char piece) { // list all possible queen moves for a given queen
-    vector<int> moves;
-    moves.reserve(27);
-    int queenDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // queen move directions
-    for (int i = 0; i < 8; i++) {
-        int dr = queenDirections[i][0];
-        int df = queenDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(encodeMove(r, f, tr, tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(encodeMove(r, f, tr, tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
-    }
-    return moves;
-}
-
-vector<int> enumerateKingMoves(int r, int f, char piece) { // list all possible king moves for a given king
-    vector<int> moves;
-    moves.reserve(10);
-    int kingDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // king move directions
-    for (int i = 0; i < 8; i++) {
-        int tr = r + kingDirections[i][0];
-        int tf = f + kingDirections[i][1];
-        if (inBounds(tr, tf)) {
-            if (board[tr][tf] == '.' || islower(board[tr][tf]) != islower(piece)) {
-                moves.push_back(encodeMove(r, f, tr, tf));
-            }
-        }
-    }
-  if (piece == 'K' && !whiteKingMoved) { // white castling
-        if (!whiteLeftRookMoved && board[7][1] == '.' && board[7][2] == '.' && board[7][3] == '.') {
-            moves.push_back(encodeMove(7, 4, 7, 2, 2)); // queenside, flag=2
-        }
-        if (!whiteRightRookMoved && board[7][5] == '.' && board[7][6] == '.') {
-            moves.push_back(encodeMove(7, 4, 7, 6, 1)); // kingside, flag=1
-        }
-    }
-    if (piece == 'k' && !blackKingMoved) { // black castling
-        if (!blackLeftRookMoved && board[0][1] == '.' && board[0][2] == '.' && board[0][3] == '.') {
-            moves.push_back(encodeMove(0, 4, 0, 2, 2)); // queenside, flag=2
-        }
-        if (!blackRightRookMoved && board[0][5] == '.' && board[0][6] == '.') {
-            moves.push_back(encodeMove(0, 4, 0, 6, 1)); // kingside, flag=1
-        }
-    }
-    return moves;
-}
-
-vector<int> enumeratePieceMoves(int r, int f) {
-    vector<int> moves;
-    char piece = board[r][f];
-    if (piece == '.') return moves; // no piece
-
-    switch (tolower(piece)) { // get moves for piece type
-        case 'p': moves = enumeratePawnMoves(r, f, piece); break;
-        case 'n': moves = enumerateKnightMoves(r, f, piece); break;
-        case 'b': moves = enumerateBishopMoves(r, f, piece); break;
-        case 'r': moves = enumerateRookMoves(r, f, piece); break;
-        case 'q': moves = enumerateQueenMoves(r, f, piece); break;
-        case 'k': moves = enumerateKingMoves(r, f, piece); break;
-    }
-    return moves; // return list of moves
-}
-
-vector<int> enumerateAllMoves(bool whiteToMove) {
-    vector<int> moves;
-    moves.reserve(50); // typical position has 30-40 legal moves
-    for (int r = 0; r < 8; r++) { // make every move for every piece of color
-        for (int f = 0; f < 8; f++) {
-            if (board[r][f] != '.' && (isupper(board[r][f]) == whiteToMove)) {
-                vector<int> pieceMoves = enumeratePieceMoves(r, f);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-        }
-    }
-    return moves;
-}
-
-int getMoveScore(int move) {
-    // Rank moves for better alpha-beta pruning
-    int score = 0;
-    int r = getFromRank(move);
-    int f = getFromFile(move);
-    int tr = getToRank(move);
-    int tf = getToFile(move);
-    char piece = board[r][f];
-    char captured = board[tr][tf];
-
-    // rank captures with MVV/LVA
-    if (captured != '.') {
-        int victimValue = 0;
-        switch (tolower(captured)) {
-            case 'p': victimValue = 1; break;
-            case 'n': victimValue = 3; break;
-            case 'b': victimValue = 3; break;
-            case 'r': victimValue = 5; break;
-            case 'q': victimValue = 9; break;
-            case 'k': victimValue = 100; break;
-        }
-        
-        int attackerValue = 0;
-        switch (tolower(piece)) {
-            case 'p': attackerValue = 1; break;
-            case 'n': attackerValue = 3; break;
-            case 'b': attackerValue = 3; break;
-            case 'r': attackerValue = 5; break;
-            case 'q': attackerValue = 9; break;
-            case 'k': attackerValue = 100; break;
-        }
-        
-        score = 1000 + (victimValue * 10) - attackerValue;
-    }
-
-    return score;
-}
-
-void orderMoves(vector<int>& moves) {
-    // Sort moves by score descending (in-place, no copy)
-    sort(moves.begin(), moves.end(), [](int a, int b) {
-        return getMoveScore(a) > getMoveScore(b);
-    });
-}
-
-int enumerateMoveTree(int depth, bool whiteToMove, int currentEval, int alpha = -10000000, int beta = 10000000) { // recursive evaluation with alpha-beta pruning
-    if (depth == 0) return immediateEvaluation(); // base case
-
-    vector<int> moves = enumerateAllMoves(whiteToMove); // get moves
-    orderMoves(moves); // order moves for better time (in-place)
-    
-    if (whiteToMove) { // for white (maximizing player)
-        int te = -10000000; // initial value
-        for (int move : moves) {
-            int r = getFromRank(move);
-            int f = getFromFile(move);
-            int tr = getToRank(move);
-            int tf = getToFile(move);
-            int flag = getMoveFlag(move);
-            char movingPiece = board[r][f];
-            char captured = board[tr][tf];
-            board[tr][tf] = movingPiece;
-            board[r][f] = '.';
-            if (flag == 1) { // kingside castle
-                board[7][5] = 'R';
-                board[7][7] = '.';
-            } else if (flag == 2) { // queenside castle
-                board[7][3] = 'R';
-                board[7][0] = '.';
-            }
-            int evaluation = enumerateMoveTree(depth - 1, false, currentEval, alpha, beta);
-            board[r][f] = movingPiece; // undo move
-            board[tr][tf] = captured;
-            if (flag == 1) {
-                board[7][7] = 'R';
-                board[7][5] = '.';
-            } else if (flag == 2) {
-                board[7][0] = 'R';
-                board[7][3] = '.';
-            }
-            te = max(te, evaluation);
-            alpha = max(alpha, te); // update alpha
-            if (beta <= alpha) break; // prune remaining branches
-        }
-        return te; // return evaluation
-    } else { // for black (minimizing player)
-        int te = 10000000; 
-        for (int move : moves) {
-            int r = getFromRank(move);
-            int f = getFromFile(move);
-            int tr = getToRank(move);
-            int tf = getToFile(move);
-            int flag = getMoveFlag(move);
-            char movingPiece = board[r][f];
-            char captured = board[tr][tf];
-            board[tr][tf] = movingPiece;
-            board[r][f] = '.';
-            if (flag == 1) { // kingside castle
-                board[0][5] = 'r';
-                board[0][7] = '.';
-            } else if (flag == 2) { // queenside castle
-                board[0][3] = 'r';
-                board[0][0] = '.';
-            }
-            int evaluation = enumerateMoveTree(depth - 1, true, currentEval, alpha, beta);
-            board[r][f] = movingPiece;
-            board[tr][tf] = captured;
-            if (flag == 1) { // undo castling move
-                board[0][7] = 'r';
-                board[0][5] = '.';
-            } else if (flag == 2) {
-                board[0][0] = 'r';
-                board[0][3] = '.';
-            }
-            te = min(te, evaluation);
-            beta = min(beta, te); // update beta
-            if (beta <= alpha) break; // prune remaining branches
-        }
-        return te;
-    }
-}
-
-int selector(int depth, int currentEval) { // select best move for black
-    vector<int> moves = enumerateAllMoves(false); // black to move
-    orderMoves(moves); // order moves for better time (in-place)
-
-    int bestMove = 0;
-    int te = 10000000;
-    
-    for (int i = 0; i < moves.size(); i++) {
-        int r = getFromRank(moves[i]);
-        int f = getFromFile(moves[i]);
-        int tr = getToRank(moves[i]);
-        int tf = getToFile(moves[i]);
-        int flag = getMoveFlag(moves[i]);
-        
-        char movingPiece = board[r][f];
-        char captured = board[tr][tf];
-        board[tr][tf] = movingPiece;
-        board[r][f] = '.';
-        
-        // Handle castling
-        if (flag == 1) { // kingside castle
-            board[0][5] = 'r';
-            board[0][7] = '.';
-        } else if (flag == 2) { // queenside castle
-            board[0][3] = 'r';
-            board[0][0] = '.';
-        }
-        
-        int evaluation = enumerateMoveTree(depth - 1, true, currentEval);
-        
-        // Undo the move immediately
-        board[r][f] = movingPiece;
-        board[tr][tf] = captured;
-        
-        if (flag == 1) {
-            board[0][7] = 'r';
-            board[0][5] = '.';
-        } else if (flag == 2) {
-            board[0][0] = 'r';
-            board[0][3] = '.';
-        }
-        
-        if (evaluation < te) {
-            te = evaluation;
-            bestMove = moves[i];
-        }
-    }
-    
-    return bestMove; // return best move
-}
-
 string convertToCoordinates(string algebraic) { // convert lan to coordinates
     string files = "abcdefgh";
     string ranks = "87654321";
@@ -569,18 +92,6 @@ string convertToAlgebraic(string coordinates) { // convert coordinates to lan
     return string(1, files[fromCol]) + string(1, ranks[fromRow]) + string(1, files[toCol]) + string(1, ranks[toRow]);
 }
 
-void whiteCastleCheck(int r, int f) {
-    if (r == 7 && f == 4) whiteKingMoved = true;
-    if (r == 7 && f == 0) whiteLeftRookMoved = true;
-    if (r == 7 && f == 7) whiteRightRookMoved = true;
-}
-
-void blackCastleCheck(int r, int f) {
-    if (r == 0 && f == 4) blackKingMoved = true;
-    if (r == 0 && f == 0) blackLeftRookMoved = true;
-    if (r == 0 && f == 7) blackRightRookMoved = true;
-}
-
 int main(int argc, char* argv[]) {
     if (argc == 2){
         engineDepth = stoi(argv[1]);
@@ -589,13 +100,12 @@ int main(int argc, char* argv[]) {
     string move;
     string response;
     int moveCount = 0;
-    bool moveValid;
+    bool moveValid = false;
     Timer timer;
 
     cout << "Welcome to \033[1mPRISM Engine V0.7\033[0m\n";
     cout << "(C) 2025 Tommy Ciccone All Rights Reserved.\n";
 
-    initializeBoard();
     printBoard();
     cout << "Evaluation: 0\n\n";
 
@@ -611,7 +121,7 @@ int main(int argc, char* argv[]) {
         int tr = coordinates[2] - '0';
         int tf = coordinates[3] - '0';
 
-        vector<int> legalMoves = enumerateAllMoves(true);
+        vector<int> legalMoves = position.generateMoves(true);
         int matchedMove = 0;
         for (int lm : legalMoves) {
             // Check for match (ignore flag for user input)
@@ -633,22 +143,10 @@ int main(int argc, char* argv[]) {
 
         moveValid = false;
 
-        whiteCastleCheck(r, f);
-
-        board[tr][tf] = board[r][f];
-        board[r][f] = '.';
-
-        int flag = getMoveFlag(matchedMove);
-        if (flag == 1) { // kingside castle
-            board[7][5] = 'R';
-            board[7][7] = '.';
-        } else if (flag == 2) { // queenside castle
-            board[7][3] = 'R';
-            board[7][0] = '.';
-        }
+        position.makeMove(matchedMove, true);
 
         printBoard();
-        int eval = immediateEvaluation();
+        int eval = evaluator.evaluate(position);
         cout << "Evaluation: " << eval << "\n\n";
         
         if (eval > 50000) {
@@ -660,10 +158,10 @@ int main(int argc, char* argv[]) {
         }
 
         cout << "Black is thinking...\n\n";
-        positionsEvaluated = 0;
+        engine.leaves = 0;
         
         timer.start();
-        int responseMove = selector(engineDepth, immediateEvaluation());
+        int responseMove = engine.bestMove(position, engineDepth, false);
         timer.stop();
         if (responseMove == 0) {
             cout << "Black has no legal moves. Game over.\n";
@@ -680,26 +178,12 @@ int main(int argc, char* argv[]) {
         string responseAlgebraic = string(1, files[bf]) + string(1, ranks[br]) + string(1, files[btf]) + string(1, ranks[btr]);
         
         cout << "Black plays: " << responseAlgebraic << "\n";
-        cout << "Evaluated " << positionsEvaluated << " positions in " << timer.getTime() << " seconds.\n";
-
-        blackCastleCheck(br, bf);
+        cout << "Evaluated " << engine.leaves << " positions in " << timer.getTime() << " seconds.\n";
 
-        board[btr][btf] = board[br][bf];
-        board[br][bf] = '.';
-
-        int responseFlag = getMoveFlag(responseMove);
-        if (responseFlag == 1) { // kingside castle
-            board[0][5] = 'r';
-            board[0][7] = '.';
-            castled = true;
-        } else if (responseFlag == 2) { // queenside castle
-            board[0][3] = 'r';
-            board[0][0] = '.';
-            castled = true;
-        }
+        position.makeMove(responseMove, false);
 
         printBoard();
-        eval = immediateEvaluation();
+        eval = evaluator.evaluate(position);
         cout << "Evaluation: " << eval << "\n\n";
         
         if (eval > 50000) {
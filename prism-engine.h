@@ -0,0 +1,732 @@
+/*
+ * PRISM Engine V0.7
+ * Tournament engine: games between bots, bot files, training data and options on top of libprism
+ * Shared by prism-tournament, tournament, evolve, tune, extract and screen
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#ifndef PRISM_ENGINE_H
+#define PRISM_ENGINE_H
+
+#include "libprism.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+using namespace std;
+
+class Timer {
+    public:
+        void start() {
+            startTime = chrono::high_resolution_clock::now();
+        }
+        void stop() {
+            endTime = chrono::high_resolution_clock::now();
+        }
+        string getTime() {
+            return to_string(chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count());
+        }
+    private:
+        chrono::high_resolution_clock::time_point startTime;
+        chrono::high_resolution_clock::time_point endTime;
+};
+
+int engineDepth = 5;
+
+Position game; // the board the tools play their games on
+
+void printBoard() { // print board to console
+    for (int i = 0; i < 8; i++) {
+        cout << "\033[90m" << 8 - i << " \033[0m";  // rank
+        for (int j = 0; j < 8; j++) {
+            char piece = game.board[i][j];
+            string unicodePiece = ".";
+            
+            // Unicode chess pieces
+            switch (piece) { 
+                case 'K': unicodePiece = "♚"; break;
+                case 'Q': unicodePiece = "♛"; break;
+                case 'R': unicodePiece = "♜"; break;
+                case 'B': unicodePiece = "♝"; break;
+                case 'N': unicodePiece = "♞"; break;
+                case 'P': unicodePiece = "♟"; break;
+                case 'k': unicodePiece = "♔"; break;
+                case 'q': unicodePiece = "♕"; break;
+                case 'r': unicodePiece = "♖"; break;
+                case 'b': unicodePiece = "♗"; break;
+                case 'n': unicodePiece = "♘"; break;
+                case 'p': unicodePiece = "♙"; break;
+            }
+            
+            cout << unicodePiece << ' ';
+        }
+        cout << "\n";
+    }
+    cout << "\033[90m  a b c d e f g h\033[0m\n"; // file
+}
+
+// Get all bot files from a directory, sorted by name
+vector<string> getBotFiles(const string& directory) {
+    vector<string> bots;
+
+    string command = "ls -1 " + directory + "/*.txt 2>/dev/null";
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        cout << "Error: Could not read directory\n";
+        return bots;
+    }
+
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        string line(buffer);
+        if (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            bots.push_back(line);
+        }
+    }
+    pclose(pipe);
+
+    sort(bots.begin(), bots.end());
+    return bots;
+}
+
+// Extract filename
+string getFilename(const string& path) {
+    size_t lastSlash = path.find_last_of("/");
+    if (lastSlash == string::npos) {
+        return path;
+    }
+    return path.substr(lastSlash + 1);
+}
+
+void importPieceSquareTables(const string& botFile, BotWeights& weights, bool verbose = true) {
+    ifstream file(botFile);
+    if (!file.is_open()) {
+        cout << "Error: Could not open " << botFile << "\n";
+        exit(1);
+    }
+
+    // Read material values (first 6 values)
+    for (int i = 0; i < 6; i++) {
+        file >> weights.materialValues[i];
+    }
+
+    // Read position PST (next 384 values: 48 groups of 8)
+    for (int piece = 0; piece < 6; piece++) {
+        for (int rank = 0; rank < 8; rank++) {
+            for (int f = 0; f < 8; f++) {
+                file >> weights.positionPST[piece][rank][f];
+            }
+        }
+    }
+
+    // Read neighbor PST (next 324 values: 54 groups of 6)
+    for (int piece = 0; piece < 6; piece++) {
+        for (int neighbor = 0; neighbor < 6; neighbor++) {
+            for (int row = 0; row < 3; row++) {
+                for (int col = 0; col < 3; col++) {
+                    file >> weights.neighborPST[piece][neighbor][row][col];
+                }
+            }
+        }
+    }
+
+    file.close();
+    if (verbose) cout << "Loaded from " << botFile << "\n";
+}
+
+// FNV-1a over the 714 values, identifies a bot by content rather than file name
+uint64_t weightsHash(const BotWeights& weights) {
+    const int* values = &weights.materialValues[0];
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < 714; i++) {
+        uint32_t value = values[i];
+        for (int b = 0; b < 4; b++) {
+            hash ^= (value >> (b * 8)) & 0xFF;
+            hash *= 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+
+FrontierPruning frontierPruning; // margins of every search the tools start
+
+string convertToCoordinates(string algebraic) { // convert lan to coordinates
+    string files = "abcdefgh";
+    string ranks = "87654321";
+
+    int fromRow = ranks.find(algebraic[1]);
+    int fromCol = files.find(algebraic[0]); 
+    int toRow = ranks.find(algebraic[3]);
+    int toCol = files.find(algebraic[2]);
+
+    return to_string(fromRow) + to_string(fromCol) + to_string(toRow) + to_string(toCol);
+}
+
+string convertToAlgebraic(string coordinates) { // convert coordinates to lan
+    string files = "abcdefgh";
+    string ranks = "87654321";
+
+    int fromRow = coordinates[0] - '0';
+    int fromCol = coordinates[1] - '0';
+    int toRow = coordinates[2] - '0';
+    int toCol = coordinates[3] - '0';
+
+    return string(1, files[fromCol]) + string(1, ranks[fromRow]) + string(1, files[toCol]) + string(1, ranks[toRow]);
+}
+
+vector<int> gameMoves; // moves played on the game board since resetGame, opening included
+
+void executeMove(int move, bool whiteToMove) { // play a move on the game board and update castling rights
+    gameMoves.push_back(move);
+    game.makeMove(move, whiteToMove);
+}
+
+bool playRandomOpening(unsigned int seed, int plies) { // play random moves so paired games share a varied start
+    mt19937 gen(seed);
+    bool whiteToMove = true;
+    for (int i = 0; i < plies; i++) {
+        vector<int> moves = game.generateMoves(whiteToMove);
+        // never let the opening decide the game
+        moves.erase(remove_if(moves.begin(), moves.end(), [](int move) {
+            return tolower(game.board[getToRank(move)][getToFile(move)]) == 'k';
+        }), moves.end());
+        if (moves.empty()) break;
+
+        uniform_int_distribution<> dis(0, moves.size() - 1);
+        executeMove(moves[dis(gen)], whiteToMove);
+        whiteToMove = !whiteToMove;
+    }
+    return whiteToMove;
+}
+
+int neutralEvaluation(const Evaluator& white, const Evaluator& black) { // average of both bots' opinions, used to break ties
+    return (white.evaluate(game) + black.evaluate(game)) / 2;
+}
+
+
+// Write weights in the layout generate and mutate use
+void writeBotWeights(const string& botFile, const BotWeights& weights) {
+    ofstream file(botFile);
+    if (!file.is_open()) {
+        cout << "Error: Could not create " << botFile << "\n";
+        return;
+    }
+
+    // Material values (6 values)
+    for (int i = 0; i < 6; i++) {
+        file << weights.materialValues[i] << (i < 5 ? " " : "\n");
+    }
+
+    // Position PST (48 groups of 8)
+    for (int piece = 0; piece < 6; piece++) {
+        for (int rank = 0; rank < 8; rank++) {
+            for (int f = 0; f < 8; f++) {
+                file << weights.positionPST[piece][rank][f] << (f < 7 ? " " : "\n");
+            }
+        }
+    }
+
+    // Neighbor PST (54 groups of 6)
+    const int* neighbor = &weights.neighborPST[0][0][0][0];
+    for (int i = 0; i < 324; i++) {
+        file << neighbor[i] << (i % 6 < 5 ? " " : "\n");
+    }
+}
+
+void resetGame() { // starting position with full castling rights
+    game.reset();
+    gameMoves.clear();
+}
+
+// Game records: a 24 byte header then 2 bytes per move, appended one game at a time
+// compact move: from square | to square << 6 | castle flag << 12, squares are rank * 8 + file
+inline uint16_t packMove(int move) {
+    return (getFromRank(move) * 8 + getFromFile(move)) | (getToRank(move) * 8 + getToFile(move)) << 6 | getMoveFlag(move) << 12;
+}
+
+inline int unpackMove(uint16_t packed) {
+    int from = packed & 63;
+    int to = (packed >> 6) & 63;
+    return encodeMove(from / 8, from % 8, to / 8, to % 8, packed >> 12);
+}
+
+const uint32_t gameRecordMagic = 0x47525250; // "PRRG"
+
+struct GameRecordHeader {
+    uint32_t magic;
+    uint16_t moveCount;
+    int8_t result;        // 1 white won, -1 black won, 0 draw
+    uint8_t reserved;
+    uint64_t whiteId;     // weightsHash of each bot
+    uint64_t blackId;
+};
+static_assert(sizeof(GameRecordHeader) == 24, "game record header layout");
+
+// Append the game just played to a record file in a single write
+bool appendGameRecord(const string& recordFile, const BotWeights& white, const BotWeights& black, int result) {
+    GameRecordHeader header = {gameRecordMagic, (uint16_t)gameMoves.size(), (int8_t)result, 0, weightsHash(white), weightsHash(black)};
+    vector<uint8_t> buffer(sizeof(header) + 2 * gameMoves.size());
+    memcpy(buffer.data(), &header, sizeof(header));
+    for (size_t i = 0; i < gameMoves.size(); i++) {
+        uint16_t packed = packMove(gameMoves[i]);
+        memcpy(&buffer[sizeof(header) + 2 * i], &packed, 2);
+    }
+
+    FILE* out = fopen(recordFile.c_str(), "ab");
+    if (!out) return false;
+    bool written = fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+    return fclose(out) == 0 && written;
+}
+
+// Training positions: fixed 36 byte records after an 8 byte file tag
+const char trainingFileTag[8] = {'P', 'R', 'I', 'S', 'M', 'T', 'P', '1'};
+
+struct TrainingRecord {
+    uint8_t squares[32];  // two squares per byte, low nibble first, see packSquare
+    uint8_t whiteToMove;
+    int8_t result;        // game result from white's point of view
+    uint16_t ply;
+};
+static_assert(sizeof(TrainingRecord) == 36, "training record layout");
+
+// 0 = empty, 1..6 = white P N B R Q K, 9..14 = black
+inline uint8_t packSquare(char piece) {
+    int pieceIdx = pieceToIndex(piece);
+    if (pieceIdx == -1) return 0;
+    return (isupper(piece) ? 0 : 8) | (pieceIdx + 1);
+}
+
+inline char unpackSquare(uint8_t code) {
+    if ((code & 7) == 0 || (code & 7) > 6) return '.';
+    char piece = "PNBRQK"[(code & 7) - 1];
+    return code & 8 ? tolower(piece) : piece;
+}
+
+void packBoard(uint8_t* squares) {
+    for (int sq = 0; sq < 64; sq += 2) {
+        squares[sq / 2] = packSquare(game.board[sq / 8][sq % 8]) | packSquare(game.board[sq / 8][sq % 8 + 1]) << 4;
+    }
+}
+
+void unpackBoard(const uint8_t* squares) {
+    for (int sq = 0; sq < 64; sq += 2) {
+        game.board[sq / 8][sq % 8] = unpackSquare(squares[sq / 2] & 15);
+        game.board[sq / 8][sq % 8 + 1] = unpackSquare(squares[sq / 2] >> 4);
+    }
+}
+
+const int maxMoves = 100; // prevent infinite games
+
+// Game adjudication, counted in plies
+struct Adjudication {
+    int resignEval = 0;          // resign once both bots see the game lost by this much, 0 = never
+    int resignPlies = 6;         // consecutive plies the eval has to stay there
+    int drawPlies = 0;           // plies without a capture or pawn move before a draw, 0 = never
+    bool repetitionDraw = true;  // draw when a position occurs for the third time
+};
+
+Adjudication adjudication;
+
+// Read the adjudication option at argv[i], moving i past its value; false if it is not one
+bool parseAdjudicationOption(int argc, char* argv[], int& i) {
+    string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--resign-eval" && hasValue) {
+        adjudication.resignEval = max(0, stoi(argv[++i]));
+    } else if (arg == "--resign-plies" && hasValue) {
+        adjudication.resignPlies = max(1, stoi(argv[++i]));
+    } else if (arg == "--draw-plies" && hasValue) {
+        adjudication.drawPlies = max(0, stoi(argv[++i]));
+    } else if (arg == "--no-repetition-draw") {
+        adjudication.repetitionDraw = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void printAdjudicationUsage() {
+    cout << "  --resign-eval <eval>   resign when both bots agree a side is down this much (default off)\n";
+    cout << "  --resign-plies <n>     consecutive plies the resign eval must hold (default 6)\n";
+    cout << "  --draw-plies <n>       draw after this many plies without a capture or pawn move (default off)\n";
+    cout << "  --no-repetition-draw   play on through threefold repetition\n";
+}
+
+// The options again, to hand the same settings to prism-tournament
+string adjudicationArguments() {
+    string args;
+    if (adjudication.resignEval > 0) {
+        args += " --resign-eval " + to_string(adjudication.resignEval) + " --resign-plies " + to_string(adjudication.resignPlies);
+    }
+    if (adjudication.drawPlies > 0) args += " --draw-plies " + to_string(adjudication.drawPlies);
+    if (!adjudication.repetitionDraw) args += " --no-repetition-draw";
+    return args;
+}
+
+// Game clocks in seconds, a base of 0 searches every move to engineDepth instead
+struct TimeControl {
+    double base = 0.0;
+    double increment = 0.0;
+    int maxDepth = 32;
+};
+
+TimeControl timeControl;
+
+// Read the clock option at argv[i], moving i past its value; false if it is not one
+bool parseTimeControlOption(int argc, char* argv[], int& i) {
+    string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--time" && hasValue) {
+        timeControl.base = max(0.0, stod(argv[++i]));
+    } else if (arg == "--increment" && hasValue) {
+        timeControl.increment = max(0.0, stod(argv[++i]));
+    } else if (arg == "--max-depth" && hasValue) {
+        timeControl.maxDepth = max(1, stoi(argv[++i]));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void printTimeControlUsage() {
+    cout << "  --time <seconds>       clock per side, searched by iterative deepening (default: fixed depth " << engineDepth << ")\n";
+    cout << "  --increment <seconds>  added to the clock after each move (default 0)\n";
+    cout << "  --max-depth <n>        deepest iteration on the clock (default 32)\n";
+}
+
+string timeControlArguments() {
+    if (timeControl.base <= 0.0) return "";
+    return " --time " + to_string(timeControl.base) + " --increment " + to_string(timeControl.increment)
+         + " --max-depth " + to_string(timeControl.maxDepth);
+}
+
+// Read a frontier pruning option at argv[i], moving i past its value; false if it is not one
+bool parsePruningOption(int argc, char* argv[], int& i) {
+    string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--futility1" && hasValue) {
+        frontierPruning.futility1 = max(0, stoi(argv[++i]));
+    } else if (arg == "--futility2" && hasValue) {
+        frontierPruning.futility2 = max(0, stoi(argv[++i]));
+    } else if (arg == "--razor" && hasValue) {
+        frontierPruning.razor3 = max(0, stoi(argv[++i]));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void printPruningUsage() {
+    FrontierPruning defaults;
+    cout << "  --futility1 <percent>  futility margin one ply from the leaves, in percent of the bot's largest\n";
+    cout << "                         material value, 0 = off (default " << defaults.futility1 << ")\n";
+    cout << "  --futility2 <percent>  futility margin two plies from the leaves (default " << defaults.futility2 << ")\n";
+    cout << "  --razor <percent>      razoring margin three plies from the leaves (default " << defaults.razor3 << ")\n";
+}
+
+string pruningArguments() {
+    return " --futility1 " + to_string(frontierPruning.futility1) + " --futility2 " + to_string(frontierPruning.futility2)
+         + " --razor " + to_string(frontierPruning.razor3);
+}
+
+// Share of the clock for this move: an even split over the moves left before the move limit, plus the increment
+double moveBudget(double remaining, int pliesPlayed) {
+    int movesLeft = max(1, (maxMoves - pliesPlayed + 1) / 2);
+    return min(remaining / movesLeft + timeControl.increment, remaining * 0.5);
+}
+
+double gameTime[2] = {0.0, 0.0}; // seconds white and black spent searching in the last game
+
+// Output handed to a background thread that writes it in batches, so a game never waits on the terminal or a pipe
+class LogWriter {
+    public:
+        LogWriter(FILE* out) : out(out) {}
+
+        ~LogWriter() {
+            close();
+        }
+
+        void write(const char* text, size_t length) {
+            unique_lock<mutex> lock(guard);
+            if (closed) { // nothing left to hand it to
+                fwrite(text, 1, length, out);
+                return;
+            }
+            pending.append(text, length);
+            if (!writer.joinable()) writer = thread(&LogWriter::run, this);
+            ready.notify_one();
+        }
+
+        // Write out everything pending and stop the thread
+        void close() {
+            {
+                lock_guard<mutex> lock(guard);
+                closed = true;
+            }
+            ready.notify_one();
+            if (writer.joinable()) writer.join();
+            fflush(out);
+        }
+
+    private:
+        FILE* out;
+        mutex guard;
+        condition_variable ready;
+        string pending;
+        bool closed = false;
+        thread writer;
+
+        void run() {
+            string batch;
+            unique_lock<mutex> lock(guard);
+            while (true) {
+                ready.wait(lock, [&]() { return closed || !pending.empty(); });
+                if (pending.empty()) break; // closed and drained
+                batch.swap(pending);
+                lock.unlock();
+                fwrite(batch.data(), 1, batch.size(), out);
+                fflush(out);
+                batch.clear();
+                lock.lock();
+            }
+        }
+};
+
+// Stream buffer for cout in quiet mode: text collects here and goes to the writer on flush or when full
+class LogBuffer : public streambuf {
+    public:
+        LogBuffer(LogWriter& writer) : writer(writer) {
+            setp(buffer, buffer + sizeof(buffer));
+        }
+
+    protected:
+        int overflow(int c) override {
+            sync();
+            if (c != EOF) {
+                *pptr() = c;
+                pbump(1);
+            }
+            return c == EOF ? 0 : c;
+        }
+
+        int sync() override {
+            if (pptr() > pbase()) writer.write(pbase(), pptr() - pbase());
+            setp(buffer, buffer + sizeof(buffer));
+            return 0;
+        }
+
+    private:
+        LogWriter& writer;
+        char buffer[1 << 16];
+};
+
+LogWriter logWriter(stdout);
+LogBuffer logBuffer(logWriter);
+streambuf* consoleBuffer = nullptr;
+
+void stopQuietOutput() {
+    if (!consoleBuffer) return;
+    cout.flush();
+    cout.rdbuf(consoleBuffer);
+    consoleBuffer = nullptr;
+    logWriter.close();
+}
+
+// Send cout through the background writer until exit, no flush costs a system call
+void startQuietOutput() {
+    if (consoleBuffer) return;
+    cout.unsetf(ios::unitbuf);
+    consoleBuffer = cout.rdbuf(&logBuffer);
+    atexit(stopQuietOutput);
+}
+
+bool logMoves = false;           // one line per move from playGame, for quiet mode
+const char* gameEndReason = "";  // how the last game ended
+
+inline const char* resultName(int result) {
+    return result == 1 ? "1-0" : (result == -1 ? "0-1" : "1/2-1/2");
+}
+
+// Coordinate notation of a move, e.g. e2e4
+string moveName(int move) {
+    string files = "abcdefgh";
+    string ranks = "87654321";
+    return string(1, files[getFromFile(move)]) + ranks[getFromRank(move)] + files[getToFile(move)] + ranks[getToRank(move)];
+}
+
+// Play one game between two bots, returns 1 if white wins, -1 if black wins, 0 for a draw
+// with finalEval set to the neutral evaluation of the final position
+int playGame(const BotWeights& white, const BotWeights& black, unsigned int openingSeed, int openingPlies, int& finalEval, bool verbose) {
+    // each side searches and judges with its own weights
+    Evaluator evaluators[2] = {Evaluator(white), Evaluator(black)};
+    Search searches[2] = {Search(evaluators[0]), Search(evaluators[1])};
+    searches[0].pruning = searches[1].pruning = frontierPruning;
+    resetGame();
+    finalEval = 0;
+
+    bool whiteToMove = true;
+    if (openingPlies > 0) {
+        whiteToMove = playRandomOpening(openingSeed, openingPlies);
+        if (verbose) {
+            cout << "Opening: " << openingPlies << " random plies (seed " << openingSeed << ")\n";
+            printBoard();
+            cout.flush();
+        }
+    }
+
+    int moveCount = 0;
+    game.history.assign(1, game.hash(whiteToMove)); // the search also scores repeats of these as draws
+    int quietPlies = 0;   // since the last capture or pawn move
+    double clock[2] = {timeControl.base, timeControl.base}; // white, black
+    gameTime[0] = gameTime[1] = 0.0;
+    int losingPlies = 0;  // consecutive plies both bots saw the same side lost, positive for white ahead
+    
+    while (moveCount < maxMoves) {
+        int side = whiteToMove ? 0 : 1;
+        vector<int> moves = game.generateMoves(whiteToMove);
+        
+        if (moves.empty()) {
+            // No legal moves: checkmate or stalemate
+            int eval = evaluators[side].evaluate(game);
+            if (eval > 50000) {
+                gameEndReason = "checkmate";
+                if (verbose) cout << "White wins by checkmate\n";
+                return 1; // White wins
+            } else if (eval < -50000) {
+                gameEndReason = "checkmate";
+                if (verbose) cout << "Black wins by checkmate\n";
+                return -1; // Black wins
+            } else {
+                gameEndReason = "stalemate";
+                finalEval = neutralEvaluation(evaluators[0], evaluators[1]);
+                if (verbose) {
+                    cout << "Stalemate\n";
+                    cout << "Final evaluation: " << finalEval << "\n";
+                }
+                return 0; // Draw
+            }
+        }
+        
+        int depth = engineDepth;
+        auto moveStart = chrono::steady_clock::now();
+        int bestMove;
+        if (timeControl.base > 0.0) {
+            double budget = moveBudget(clock[side], moveCount);
+            bestMove = searches[side].timedBestMove(game, whiteToMove, budget, min(budget * 4, clock[side] * 0.8), timeControl.maxDepth, depth);
+        } else {
+            bestMove = searches[side].bestMove(game, engineDepth, whiteToMove);
+        }
+        double used = chrono::duration<double>(chrono::steady_clock::now() - moveStart).count();
+        gameTime[side] += used;
+
+        if (timeControl.base > 0.0) {
+            clock[side] -= used;
+            if (clock[side] < 0.0) {
+                gameEndReason = "time";
+                if (verbose) cout << (whiteToMove ? "White" : "Black") << " lost on time\n";
+                return whiteToMove ? -1 : 1;
+            }
+            clock[side] += timeControl.increment;
+        }
+
+        bool progress = game.board[getToRank(bestMove)][getToFile(bestMove)] != '.'
+                     || tolower(game.board[getFromRank(bestMove)][getFromFile(bestMove)]) == 'p';
+        
+        // Execute move
+        executeMove(bestMove, whiteToMove);
+        
+        int eval = evaluators[side].evaluate(game);
+        if (verbose) {
+            printBoard();
+            cout << "Evaluation: " << eval << "\n";
+            cout << "Time: " << round(used * 1000) / 1000 << "s at depth " << depth;
+            if (timeControl.base > 0.0) cout << ", clock " << round(clock[side] * 1000) / 1000 << "s";
+            cout << "\n\n";
+            cout.flush();
+        } else if (logMoves) {
+            cout << "move ply=" << gameMoves.size() << " move=" << moveName(bestMove) << " eval=" << eval
+                 << " depth=" << depth << " time=" << round(used * 1000) / 1000 << "\n";
+        }
+        
+        // Check for checkmate
+        if (eval > 50000) {
+            gameEndReason = "checkmate";
+            if (verbose) cout << "White wins by checkmate\n";
+            return 1; // White wins
+        } else if (eval < -50000) {
+            gameEndReason = "checkmate";
+            if (verbose) cout << "Black wins by checkmate\n";
+            return -1; // Black wins
+        }
+        
+        whiteToMove = !whiteToMove;
+        moveCount++;
+
+        if (adjudication.resignEval > 0) {
+            int whiteOpinion = evaluators[0].evaluate(game);
+            int blackOpinion = evaluators[1].evaluate(game);
+
+            if (whiteOpinion >= adjudication.resignEval && blackOpinion >= adjudication.resignEval) {
+                losingPlies = losingPlies > 0 ? losingPlies + 1 : 1;
+            } else if (whiteOpinion <= -adjudication.resignEval && blackOpinion <= -adjudication.resignEval) {
+                losingPlies = losingPlies < 0 ? losingPlies - 1 : -1;
+            } else {
+                losingPlies = 0;
+            }
+            if (abs(losingPlies) >= adjudication.resignPlies) {
+                gameEndReason = "resignation";
+                if (verbose) cout << (losingPlies > 0 ? "Black resigns\n" : "White resigns\n");
+                return losingPlies > 0 ? 1 : -1;
+            }
+        }
+
+        quietPlies = progress ? 0 : quietPlies + 1;
+        if (adjudication.drawPlies > 0 && quietPlies >= adjudication.drawPlies) {
+            gameEndReason = "no-progress";
+            finalEval = neutralEvaluation(evaluators[0], evaluators[1]);
+            if (verbose) {
+                cout << "Draw after " << quietPlies << " plies without progress\n";
+                cout << "Evaluation: " << finalEval << "\n";
+            }
+            return 0;
+        }
+
+        uint64_t hash = game.hash(whiteToMove);
+        game.history.push_back(hash);
+        if (adjudication.repetitionDraw && count(game.history.begin(), game.history.end(), hash) >= 3) {
+            gameEndReason = "repetition";
+            finalEval = neutralEvaluation(evaluators[0], evaluators[1]);
+            if (verbose) {
+                cout << "Draw by threefold repetition\n";
+                cout << "Evaluation: " << finalEval << "\n";
+            }
+            return 0;
+        }
+    }
+    
+    gameEndReason = "move-limit";
+    finalEval = neutralEvaluation(evaluators[0], evaluators[1]);
+    if (verbose) {
+        cout << "Game ended in draw by move limit\n";
+        cout << "Evaluation: " << finalEval << "\n";
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * PRISM Engine V0.7
+ * Bot values: random bots, mutation and crossover, shared by generate, mutate and evolve
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#ifndef PRISM_MUTATION_H
+#define PRISM_MUTATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const int botValueCount = 714; // 6 material + 384 position PST + 324 neighbor PST
+
+inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256**, cheap enough to seed one per child
+class FastRandom {
+    public:
+        FastRandom(uint64_t seed) {
+            for (int i = 0; i < 4; i++) s[i] = splitmix64(seed);
+        }
+
+        uint64_t next() {
+            uint64_t result = rotl(s[1] * 5, 7) * 9;
+            uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+
+        // uniform in [0, range)
+        uint32_t below(uint32_t range) {
+            return (uint32_t)(((next() >> 32) * range) >> 32);
+        }
+
+        // uniform in [0, 1)
+        double unit() {
+            return (next() >> 11) * 0x1.0p-53;
+        }
+
+    private:
+        uint64_t s[4];
+
+        static uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+};
+
+// The functions below take any Random with next(), below() and unit() like FastRandom
+
+// Random bot: material values from 5 to 200, table values from -100 to 100
+template <class Random>
+void randomizeBotValues(int* values, Random& rng) {
+    for (int i = 0; i < botValueCount; i++) {
+        values[i] = i < 6 ? 5 + (int)rng.below(196) : (int)rng.below(201) - 100;
+    }
+}
+
+// Each value gets +-50 with chance factor, then material is clamped to 1..1000 and tables to -200..200.
+// Values that do not mutate are left as they are, however far out of range.
+template <class Random>
+void mutateBotValues(int* values, double factor, Random& rng) {
+    // chance test against a 64 bit threshold instead of a floating point draw
+    bool always = factor >= 1.0;
+    uint64_t threshold = always ? 0 : (uint64_t)(factor * 18446744073709551616.0);
+    for (int i = 0; i < botValueCount; i++) {
+        if (always || rng.next() < threshold) {
+            values[i] += (int)rng.below(101) - 50;
+            if (i < 6) {
+                values[i] = std::max(1, std::min(1000, values[i]));
+            } else {
+                values[i] = std::max(-200, std::min(200, values[i]));
+            }
+        }
+    }
+}
+
+// Uniform crossover: every value from a random parent, parents[p][i] is value i of parent p
+template <class Parents, class Random>
+void uniformCrossover(const Parents& parents, size_t parentCount, int* child, Random& rng) {
+    for (int i = 0; i < botValueCount; i++) {
+        child[i] = parents[rng.below(parentCount)][i];
+    }
+}
+
+// Blend crossover: a weighted average of the parents with random weights per child
+template <class Parents, class Random>
+void blendCrossover(const Parents& parents, size_t parentCount, int* child, Random& rng) {
+    std::vector<double> weights(parentCount);
+    double total = 0.0;
+    for (size_t p = 0; p < parentCount; p++) {
+        weights[p] = rng.unit() + 1e-9;
+        total += weights[p];
+    }
+    for (int i = 0; i < botValueCount; i++) {
+        double blended = 0.0;
+        for (size_t p = 0; p < parentCount; p++) {
+            blended += weights[p] * parents[p][i];
+        }
+        child[i] = (int)lround(blended / total);
+    }
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * PRISM Engine V0.7
+ * Population evaluation: one position scored for many bots at once
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#ifndef PRISM_POPULATION_H
+#define PRISM_POPULATION_H
+
+#include "prism-engine.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Weights stored struct of arrays: row i holds value i of every bot, so a feature
+// adds one contiguous row to the scores instead of gathering from 714 int strides.
+// Lanes are 32 bit, a score can exceed 16 bits (16 * 1000 material plus the tables).
+class PopulationWeights {
+    public:
+        static const int blockSize = 64; // bots scored together while their sums stay in registers
+
+        PopulationWeights(size_t bots) : botCount(bots), stride((bots + blockSize - 1) / blockSize * blockSize) {
+            values.assign(714 * stride, 0);
+        }
+
+        size_t size() const {
+            return botCount;
+        }
+
+        void setBot(size_t bot, const BotWeights& weights) {
+            const int* source = &weights.materialValues[0];
+            for (int i = 0; i < 714; i++) values[i * stride + bot] = source[i];
+        }
+
+        // scores[bot] for every bot, scores needs room for size() values. A feature with coefficient +-n
+        // appears n times in plus or minus, so every row is added or subtracted and nothing is multiplied.
+        void evaluate(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                      int32_t* scores) const {
+            evaluateRange(plus, plusCount, minus, minusCount, constant, 0, botCount, scores);
+        }
+
+        // Bots [first, last) only, first must be a multiple of blockSize
+        void evaluateRange(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                           size_t first, size_t last, int32_t* scores) const {
+            int32_t block[blockSize];
+            for (size_t bot = first; bot < last; bot += blockSize) {
+                evaluateBlock(plus, plusCount, minus, minusCount, constant, bot, block);
+                size_t filled = min((size_t)blockSize, last - bot);
+                copy(block, block + filled, scores + bot);
+            }
+        }
+
+    private:
+        size_t botCount;
+        size_t stride;           // row length, padded to whole blocks
+        vector<int32_t> values;  // values[index * stride + bot]
+
+#if defined(__AVX512F__)
+        void evaluateBlock(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                           size_t bot, int32_t* out) const {
+            __m512i sum[4];
+            for (int v = 0; v < 4; v++) sum[v] = _mm512_set1_epi32(constant);
+            for (int f = 0; f < plusCount; f++) {
+                const int32_t* row = &values[plus[f] * stride + bot];
+                for (int v = 0; v < 4; v++) sum[v] = _mm512_add_epi32(sum[v], _mm512_loadu_si512(row + 16 * v));
+            }
+            for (int f = 0; f < minusCount; f++) {
+                const int32_t* row = &values[minus[f] * stride + bot];
+                for (int v = 0; v < 4; v++) sum[v] = _mm512_sub_epi32(sum[v], _mm512_loadu_si512(row + 16 * v));
+            }
+            for (int v = 0; v < 4; v++) _mm512_storeu_si512(out + 16 * v, sum[v]);
+        }
+#elif defined(__AVX2__)
+        void evaluateBlock(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                           size_t bot, int32_t* out) const {
+            __m256i sum[8];
+            for (int v = 0; v < 8; v++) sum[v] = _mm256_set1_epi32(constant);
+            for (int f = 0; f < plusCount; f++) {
+                const int32_t* row = &values[plus[f] * stride + bot];
+                for (int v = 0; v < 8; v++) {
+                    sum[v] = _mm256_add_epi32(sum[v], _mm256_loadu_si256((const __m256i*)(row + 8 * v)));
+                }
+            }
+            for (int f = 0; f < minusCount; f++) {
+                const int32_t* row = &values[minus[f] * stride + bot];
+                for (int v = 0; v < 8; v++) {
+                    sum[v] = _mm256_sub_epi32(sum[v], _mm256_loadu_si256((const __m256i*)(row + 8 * v)));
+                }
+            }
+            for (int v = 0; v < 8; v++) _mm256_storeu_si256((__m256i*)(out + 8 * v), sum[v]);
+        }
+#elif defined(__ARM_NEON)
+        void evaluateBlock(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                           size_t bot, int32_t* out) const {
+            int32x4_t sum[16];
+            for (int v = 0; v < 16; v++) sum[v] = vdupq_n_s32(constant);
+            for (int f = 0; f < plusCount; f++) {
+                const int32_t* row = &values[plus[f] * stride + bot];
+                for (int v = 0; v < 16; v++) sum[v] = vaddq_s32(sum[v], vld1q_s32(row + 4 * v));
+            }
+            for (int f = 0; f < minusCount; f++) {
+                const int32_t* row = &values[minus[f] * stride + bot];
+                for (int v = 0; v < 16; v++) sum[v] = vsubq_s32(sum[v], vld1q_s32(row + 4 * v));
+            }
+            for (int v = 0; v < 16; v++) vst1q_s32(out + 4 * v, sum[v]);
+        }
+#else
+        void evaluateBlock(const uint16_t* plus, int plusCount, const uint16_t* minus, int minusCount, int constant,
+                           size_t bot, int32_t* out) const {
+            for (int b = 0; b < blockSize; b++) out[b] = constant;
+            for (int f = 0; f < plusCount; f++) {
+                const int32_t* row = &values[plus[f] * stride + bot];
+                for (int b = 0; b < blockSize; b++) out[b] += row[b];
+            }
+            for (int f = 0; f < minusCount; f++) {
+                const int32_t* row = &values[minus[f] * stride + bot];
+                for (int b = 0; b < blockSize; b++) out[b] -= row[b];
+            }
+        }
+#endif
+};
+
+// Name of the kernel compiled in, for reports
+inline const char* populationKernel() {
+#if defined(__AVX512F__)
+    return "AVX-512, 16 bots per instruction";
+#elif defined(__AVX2__)
+    return "AVX2, 8 bots per instruction";
+#elif defined(__ARM_NEON)
+    return "NEON, 4 bots per instruction";
+#else
+    return "scalar";
+#endif
+}
+
+#endif
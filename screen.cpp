@@ -0,0 +1,203 @@
+/*
+ * PRISM Engine V0.7
+ * Population Fitness Screening on Labeled Positions
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "prism-population.h"
+
+#include <cmath>
+#include <thread>
+
+// Labeled positions as ranges into one flat array of weight rows, the rows a position adds
+// come first and the rows it subtracts after them
+struct ScreenPositions {
+    vector<uint16_t> rows;
+    vector<uint32_t> first;    // first row of each position, plus an end marker
+    vector<uint32_t> minus;    // first subtracted row of each position
+    vector<int> constants;
+    vector<int8_t> results;
+};
+
+// Per bot totals over all positions
+struct ScreenScore {
+    double loss = 0.0;     // squared error of the predicted score
+    long correct = 0;      // decisive positions where the eval favors the winner
+};
+
+// Positions from a training file written by extract
+bool loadPositions(const string& path, ScreenPositions& positions, long limit) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+
+    char tag[8];
+    if (fread(tag, 1, 8, in) != 8 || memcmp(tag, trainingFileTag, 8) != 0) {
+        fclose(in);
+        return false;
+    }
+
+    game.whiteCastled = game.blackCastled = false; // not stored in training records
+    TrainingRecord record;
+    vector<Feature> features;
+    while ((limit == 0 || (long)positions.results.size() < limit) && fread(&record, sizeof(record), 1, in) == 1) {
+        unpackBoard(record.squares);
+        features.clear();
+        extractFeatures(game, features);
+
+        // a merged coefficient of +-n becomes the row n times, cancelled pairs are already gone
+        positions.first.push_back(positions.rows.size());
+        for (const Feature& feature : features) {
+            for (int n = 0; n < feature.coefficient; n++) positions.rows.push_back(feature.index);
+        }
+        positions.minus.push_back(positions.rows.size());
+        for (const Feature& feature : features) {
+            for (int n = 0; n < -feature.coefficient; n++) positions.rows.push_back(feature.index);
+        }
+        positions.constants.push_back(evaluationConstant(game));
+        positions.results.push_back(record.result);
+    }
+    positions.first.push_back(positions.rows.size());
+    fclose(in);
+    return true;
+}
+
+// Score bots [first, last) on every position
+void screenBots(const PopulationWeights& population, const ScreenPositions& positions, double k,
+                size_t first, size_t last, vector<ScreenScore>& scores) {
+    vector<int32_t> evals(population.size());
+    for (size_t p = 0; p < positions.results.size(); p++) {
+        const uint16_t* plus = &positions.rows[positions.first[p]];
+        const uint16_t* minus = &positions.rows[positions.minus[p]];
+        int plusCount = positions.minus[p] - positions.first[p];
+        int minusCount = positions.first[p + 1] - positions.minus[p];
+        population.evaluateRange(plus, plusCount, minus, minusCount, positions.constants[p], first, last, evals.data());
+
+        int result = positions.results[p];
+        double target = (result + 1) / 2.0;
+        for (size_t bot = first; bot < last; bot++) {
+            double error = target - 1.0 / (1.0 + exp(-k * evals[bot]));
+            scores[bot].loss += error * error;
+            if (result != 0 && (evals[bot] > 0) == (result > 0) && evals[bot] != 0) scores[bot].correct++;
+        }
+    }
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <bots_directory> <training_file> [options]\n";
+    cout << "Options:\n";
+    cout << "  --k <scale>            sigmoid scale turning evals into expected scores (default 0.005)\n";
+    cout << "  --limit <n>            positions to read, 0 for all (default 0)\n";
+    cout << "  --top <n>              bots to list, 0 for all (default 20)\n";
+    cout << "  --threads <n>          worker threads (default: all cores)\n";
+}
+
+int main(int argc, char* argv[]) {
+    cout.setf(ios::unitbuf); // Enable unbuffered output
+
+    string botsDir, trainingFile;
+    double k = 0.005;
+    long limit = 0;
+    size_t top = 20;
+    int threadCount = max(1u, thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--k" && hasValue) {
+            k = stod(argv[++i]);
+        } else if (arg == "--limit" && hasValue) {
+            limit = stol(argv[++i]);
+        } else if (arg == "--top" && hasValue) {
+            top = stoul(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            threadCount = max(1, stoi(argv[++i]));
+        } else if (arg[0] != '-' && botsDir.empty()) {
+            botsDir = arg;
+        } else if (arg[0] != '-' && trainingFile.empty()) {
+            trainingFile = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (botsDir.empty() || trainingFile.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Remove trailing slash
+    if (botsDir.back() == '/') {
+        botsDir.pop_back();
+    }
+
+    vector<string> bots = getBotFiles(botsDir);
+    if (bots.empty()) {
+        cout << "Error: No bots found in " << botsDir << "\n";
+        return 1;
+    }
+
+    PopulationWeights population(bots.size());
+    for (size_t i = 0; i < bots.size(); i++) {
+        BotWeights weights;
+        importPieceSquareTables(bots[i], weights, false);
+        population.setBot(i, weights);
+    }
+
+    ScreenPositions positions;
+    if (!loadPositions(trainingFile, positions, limit)) {
+        cout << "Error: " << trainingFile << " is not a training file from extract\n";
+        return 1;
+    }
+    if (positions.results.empty()) {
+        cout << "Error: No positions in " << trainingFile << "\n";
+        return 1;
+    }
+
+    cout << "Screening " << bots.size() << " bots on " << positions.results.size() << " positions ("
+         << populationKernel() << ")\n";
+
+    // threads take whole blocks of bots
+    size_t blocks = (bots.size() + PopulationWeights::blockSize - 1) / PopulationWeights::blockSize;
+    threadCount = max(1, min(threadCount, (int)blocks));
+    size_t blocksPerThread = (blocks + threadCount - 1) / threadCount;
+
+    vector<ScreenScore> scores(bots.size());
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        size_t first = t * blocksPerThread * PopulationWeights::blockSize;
+        size_t last = min(bots.size(), first + blocksPerThread * PopulationWeights::blockSize);
+        if (first >= last) break;
+        workers.emplace_back(screenBots, cref(population), cref(positions), k, first, last, ref(scores));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long decisive = 0;
+    for (int8_t result : positions.results) {
+        if (result != 0) decisive++;
+    }
+
+    vector<size_t> order(bots.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return scores[a].loss < scores[b].loss;
+    });
+
+    size_t listed = top == 0 ? order.size() : min(top, order.size());
+    for (size_t i = 0; i < listed; i++) {
+        const ScreenScore& score = scores[order[i]];
+        printf("%4zu. %-20s loss %.5f  correct %5.1f%%\n", i + 1, getFilename(bots[order[i]]).c_str(),
+               score.loss / positions.results.size(), decisive > 0 ? 100.0 * score.correct / decisive : 0.0);
+    }
+    fflush(stdout);
+
+    cout << "Scored " << bots.size() * positions.results.size() << " bot positions in " << elapsed << " seconds ("
+         << (long)(bots.size() * positions.results.size() / max(elapsed, 1e-9)) << " per second)\n";
+
+    return 0;
+}
@@ -8,132 +8,1317 @@
 #include <cstdio>
 #include <fstream>
 #include <sstream>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
 
-using namespace std;
+#include "prism-engine.h"
 
-// Get all bot files from a directory
-vector<string> getBotFiles(const string& directory) {
-    vector<string> bots;
-    
-    string command = "ls -1 " + directory + "/*.txt 2>/dev/null";
-    FILE* pipe = popen(command.c_str(), "r");
-    
-    if (!pipe) {
-        cout << "Error: Could not read directory\n";
-        return bots;
-    }
-    
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        string line(buffer);
-        // Remove newline
-        if (!line.empty() && line.back() == '\n') {
-            line.pop_back();
-        }
-        if (!line.empty()) {
-            bots.push_back(line);
-        }
-    }
-    
-    pclose(pipe);
-    
-    // Sort
-    sort(bots.begin(), bots.end());
-    return bots;
-}
+using namespace std;
 
 // Shuffle bots
-void shuffleBots(vector<string>& bots) {
-    random_device rd;
-    mt19937 gen(rd());
+void shuffleBots(vector<string>& bots, mt19937& gen) {
     shuffle(bots.begin(), bots.end(), gen);
 }
 
-// Extract filename
-string getFilename(const string& path) {
-    size_t lastSlash = path.find_last_of("/");
-    if (lastSlash == string::npos) {
-        return path;
-    }
-    return path.substr(lastSlash + 1);
+// Sequential probability ratio test settings for paired matches
+struct SPRTConfig {
+    bool enabled = false;
+    double elo0 = -25.0;   // H0: first bot is weaker by this much
+    double elo1 = 25.0;    // H1: first bot is stronger by this much
+    double alpha = 0.05;   // chance of accepting H1 when H0 is true
+    double beta = 0.05;    // chance of accepting H0 when H1 is true
+    int maxPairs = 10;     // stop and fall back to tie breaks after this many pairs
+    int openingPlies = 6;  // random plies shared by both games of a pair
+};
+
+// Folder prism-tournament reads its bots from, workers sharing a host each use their own
+string matchDirectory = "./match_temp";
+
+// Binary game log prism-tournament appends every game to, empty to keep none
+string recordFile;
+bool quietOutput = false; // matches report one structured line each instead of every board
+
+// Game results keyed on both bots' contents and everything else that decides a game, so a
+// repeated pairing is answered without replaying it. Entries are appended as they finish.
+class ResultCache {
+    public:
+        string path = "./match.cache"; // empty = no caching
+
+        bool lookup(const string& key, int& result, int& finalEval) {
+            load();
+            auto entry = entries.find(key);
+            if (entry == entries.end()) return false;
+            result = entry->second.first;
+            finalEval = entry->second.second;
+            return true;
+        }
+
+        void store(const string& key, int result, int finalEval) {
+            entries[key] = {result, finalEval};
+            ofstream out(path, ios::app);
+            out << key << " " << result << " " << finalEval << "\n";
+        }
+
+        // Settings part of the key: search depth and move limit, plus a hash of the engine
+        // binary so rebuilding with different play rules starts a fresh set of results
+        const string& settings() {
+            load();
+            return settingsKey;
+        }
+
+    private:
+        bool loaded = false;
+        string settingsKey;
+        map<string, pair<int, int>> entries;
+
+        void load() {
+            if (loaded) return;
+            loaded = true;
+
+            ifstream engine("./prism-tournament", ios::binary);
+            string binary((istreambuf_iterator<char>(engine)), istreambuf_iterator<char>());
+            uint64_t hash = 0xCBF29CE484222325ULL;
+            for (char c : binary) {
+                hash ^= (uint8_t)c;
+                hash *= 0x100000001B3ULL;
+            }
+            char buffer[96];
+            snprintf(buffer, sizeof(buffer), "d%d m%d e%016llx", engineDepth, maxMoves, (unsigned long long)hash);
+            settingsKey = buffer;
+
+            // lines: <white hash> <black hash> <settings: 3 fields> <seed> <plies> <adjudication> <pruning> <result> <eval>
+            ifstream in(path);
+            string line;
+            while (getline(in, line)) {
+                size_t evalStart = line.find_last_of(' ');
+                if (evalStart == string::npos) continue;
+                size_t resultStart = line.find_last_of(' ', evalStart - 1);
+                if (resultStart == string::npos) continue;
+                entries[line.substr(0, resultStart)] = {atoi(line.c_str() + resultStart + 1), atoi(line.c_str() + evalStart + 1)};
+            }
+        }
+};
+
+ResultCache resultCache;
+
+string botHash(const string& botFile) {
+    BotWeights weights;
+    importPieceSquareTables(botFile, weights, false);
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)weightsHash(weights));
+    return buffer;
 }
 
 // Run a match between two bots, returns result and sets finalEval for draws
-int runMatch(const string& whiteBot, const string& blackBot, int& finalEval) {
+int runMatch(const string& whiteBot, const string& blackBot, int& finalEval, unsigned int openingSeed = 0, int openingPlies = 0) {
+    string cacheKey;
+    if (!resultCache.path.empty() && timeControl.base <= 0.0) { // a timed game depends on the machine, never cached
+        cacheKey = botHash(whiteBot) + " " + botHash(blackBot) + " " + resultCache.settings() + " "
+                 + to_string(openingPlies > 0 ? openingSeed : 0) + " " + to_string(openingPlies) + " a"
+                 + to_string(adjudication.resignEval) + "," + to_string(adjudication.resignPlies) + ","
+                 + to_string(adjudication.drawPlies) + "," + to_string(adjudication.repetitionDraw) + " f"
+                 + to_string(frontierPruning.futility1) + "," + to_string(frontierPruning.futility2) + ","
+                 + to_string(frontierPruning.razor3);
+        int cached;
+        // a cached game has no record, so a recording run plays every game and only stores results
+        if (recordFile.empty() && resultCache.lookup(cacheKey, cached, finalEval)) {
+            if (quietOutput) {
+                cout << "game white=" << getFilename(whiteBot) << " black=" << getFilename(blackBot) << " result="
+                     << resultName(cached) << " reason=cached eval=" << finalEval << "\n";
+            } else {
+                cout << "Cached: " << getFilename(whiteBot) << " vs " << getFilename(blackBot) << " "
+                     << (cached == 1 ? "1-0" : (cached == -1 ? "0-1" : "1/2-1/2")) << "\n";
+            }
+            return cached;
+        }
+    }
+
     // Put two bots into the folder tournament reads from
-    system("mkdir -p ./match_temp");
-    string cpWhite = "cp \"" + whiteBot + "\" ./match_temp/white_bot.txt";
-    string cpBlack = "cp \"" + blackBot + "\" ./match_temp/black_bot.txt";
+    string mkdirCmd = "mkdir -p " + matchDirectory;
+    system(mkdirCmd.c_str());
+    string cpWhite = "cp \"" + whiteBot + "\" " + matchDirectory + "/white_bot.txt";
+    string cpBlack = "cp \"" + blackBot + "\" " + matchDirectory + "/black_bot.txt";
     system(cpWhite.c_str());
     system(cpBlack.c_str());
     
-    int result = system("./prism-tournament ./match_temp");
+    string command = "./prism-tournament " + matchDirectory;
+    if (openingPlies > 0) {
+        command += " --opening-seed " + to_string(openingSeed) + " --opening-plies " + to_string(openingPlies);
+    }
+    if (!recordFile.empty()) {
+        command += " --record \"" + recordFile + "\"";
+    }
+    command += adjudicationArguments() + timeControlArguments() + pruningArguments();
+
+    int result;
+    if (quietOutput) {
+        // the game's lines come back through our own buffered output, named after the bots
+        command += logMoves ? " --quiet --log-moves" : " --quiet";
+        FILE* pipe = popen(command.c_str(), "r");
+        if (pipe) {
+            string names = "game white=" + getFilename(whiteBot) + " black=" + getFilename(blackBot) + " ";
+            char line[512];
+            while (fgets(line, sizeof(line), pipe) != nullptr) {
+                if (strncmp(line, "game ", 5) == 0) cout << names << line + 5;
+                else cout << line;
+            }
+            result = pclose(pipe);
+        } else {
+            result = -1;
+        }
+    } else {
+        result = system(command.c_str());
+    }
     
     // get previous evaluation if draw (to prevent repetitive draws)
     finalEval = 0;
-    ifstream evalFile("./match_temp/final_eval.txt");
+    ifstream evalFile(matchDirectory + "/final_eval.txt");
     if (evalFile.is_open()) {
         evalFile >> finalEval;
         evalFile.close();
     }
     
     // Clean up files
-    system("rm -rf ./match_temp");
+    string cleanupCmd = "rm -rf " + matchDirectory;
+    system(cleanupCmd.c_str());
     
     // system returns 256 for some reason
+    int outcome;
     if (result == 256) {
-        return 1; // White wins
+        outcome = 1; // White wins
     } else if (result == 0) {
-        return 0; // Draw
+        outcome = 0; // Draw
+    } else {
+        outcome = -1; // Black wins
+    }
+
+    // only clean exits (0, 1 and -1 as 255) are real results
+    if (!cacheKey.empty() && (result == 0 || result == 256 || result == 255 * 256)) {
+        resultCache.store(cacheKey, outcome, finalEval);
+    }
+    return outcome;
+}
+
+// Expected score for an elo difference under the logistic model
+double eloToScore(double elo) {
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+// Log likelihood ratio of H1 over H0 from pentanomial pair counts
+// penta[k] counts pairs where the first bot scored k/2 points out of 2
+double sprtLLR(const int penta[5], double elo0, double elo1) {
+    int pairs = 0;
+    double mean = 0.0;
+    for (int k = 0; k < 5; k++) {
+        pairs += penta[k];
+        mean += penta[k] * (k / 4.0);
+    }
+    if (pairs == 0) return 0.0;
+    mean /= pairs;
+
+    double variance = 0.0;
+    for (int k = 0; k < 5; k++) {
+        variance += penta[k] * (k / 4.0 - mean) * (k / 4.0 - mean);
+    }
+    variance /= pairs;
+    variance = max(variance, 0.01); // a run of identical pairs would otherwise give an infinite ratio
+
+    // normal approximation of the generalized SPRT
+    double s0 = eloToScore(elo0);
+    double s1 = eloToScore(elo1);
+    return pairs * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance);
+}
+
+// Play bot1 as white then as black from the same opening, returns bot1's half points (0-4)
+// and adds bot1's eval advantage over drawn games to evalSum
+int playGamePair(const string& bot1, const string& bot2, unsigned int openingSeed, int openingPlies, int& evalSum) {
+    int eval1 = 0;
+    int eval2 = 0;
+    int result1 = runMatch(bot1, bot2, eval1, openingSeed, openingPlies);
+    int result2 = runMatch(bot2, bot1, eval2, openingSeed, openingPlies);
+
+    if (result1 == 0) evalSum += eval1;
+    if (result2 == 0) evalSum -= eval2;
+    return (result1 + 1) + (1 - result2);
+}
+
+// Play color swapped game pairs until the SPRT decides, returns 1 if bot1 is stronger, -1 if bot2 is,
+// 0 if undecided with finalEval set to bot1's summed advantage over the drawn games
+int runSPRTMatch(const string& bot1, const string& bot2, const SPRTConfig& sprt, unsigned int seed, int& finalEval) {
+    mt19937 gen(seed);
+
+    double lower = log(sprt.beta / (1.0 - sprt.alpha));
+    double upper = log((1.0 - sprt.beta) / sprt.alpha);
+
+    int penta[5] = {0, 0, 0, 0, 0};
+    int points = 0; // half points scored by bot1
+    finalEval = 0;
+
+    for (int pair = 1; pair <= sprt.maxPairs; pair++) {
+        int pairPoints = playGamePair(bot1, bot2, gen(), sprt.openingPlies, finalEval);
+        penta[pairPoints]++;
+        points += pairPoints;
+
+        double llr = sprtLLR(penta, sprt.elo0, sprt.elo1);
+        cout << "Pair " << pair << ": " << pairPoints / 2.0 << "/2, score " << points / 2.0 << "/" << pair * 2
+             << ", LLR " << llr << " [" << lower << ", " << upper << "]\n";
+        cout.flush();
+
+        if (llr >= upper) return 1;
+        if (llr <= lower) return -1;
+    }
+
+    // no decision, let the overall score settle it before tie breaks
+    if (points > sprt.maxPairs * 2) return 1;
+    if (points < sprt.maxPairs * 2) return -1;
+    return 0;
+}
+
+// Decide a pairing, returns 1 if bot1 advances, -1 if bot2 advances, 0 for a draw (finalEval from bot1's side)
+int decideMatch(const string& bot1, const string& bot2, const SPRTConfig& sprt, unsigned int seed, int& finalEval) {
+    if (sprt.enabled) {
+        return runSPRTMatch(bot1, bot2, sprt, seed, finalEval);
+    }
+    return runMatch(bot1, bot2, finalEval);
+}
+
+// One unit of schedulable work, run locally or handed to a worker
+struct MatchJob {
+    int kind = 0;          // 0 = decide a knockout pairing, 1 = play one color swapped game pair
+    string bot1;
+    string bot2;
+    unsigned int seed = 0;
+    int result = 0;        // decideMatch result, or bot1's half points for a game pair
+    int finalEval = 0;
+};
+
+void runJobLocally(MatchJob& job, const SPRTConfig& sprt) {
+    job.finalEval = 0;
+    if (job.kind == 0) {
+        job.result = decideMatch(job.bot1, job.bot2, sprt, job.seed, job.finalEval);
     } else {
-        return -1; // Black wins
+        job.result = playGamePair(job.bot1, job.bot2, job.seed, sprt.openingPlies, job.finalEval);
     }
 }
 
-int main(int argc, char* argv[]) {
-    cout.setf(ios::unitbuf); // Enable unbuffered output
-    
-    if (argc != 2) {
-        cout << "Usage: " << argv[0] << " <bots_directory>\n";
+// Coordinator/worker protocol, one message per line over TCP:
+//   worker:      HELLO prism-worker 5
+//   coordinator: JOB <id> <kind> <seed> <sprt enabled> <elo0> <elo1> <alpha> <beta> <max pairs> <opening plies>
+//                    <resign eval> <resign plies> <draw plies> <repetition draw> <clock> <increment> <max depth>
+//                    <futility1> <futility2> <razor> <record games>
+//                BOT <count> <values...>   (bot1, then bot2 on the next line)
+//   worker:      RESULT <id> <result> <final eval> <game records in hex, - if none>
+
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Buffers a socket and splits what arrives into lines
+class LineReader {
+    public:
+        LineReader(int fd = -1) : fd(fd) {}
+
+        // read whatever is available, false once the peer is gone
+        bool fill() {
+            char chunk[65536];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) return true;
+            if (n <= 0) return false;
+            buffer.append(chunk, n);
+            return true;
+        }
+
+        bool nextLine(string& line) {
+            size_t end = buffer.find('\n');
+            if (end == string::npos) return false;
+            line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            return true;
+        }
+
+        // blocks until a full line arrives
+        bool readLine(string& line) {
+            while (!nextLine(line)) {
+                if (!fill()) return false;
+            }
+            return true;
+        }
+
+    private:
+        int fd;
+        string buffer;
+};
+
+// Game records travel as hex so a RESULT stays one line
+string toHex(const string& bytes) {
+    if (bytes.empty()) return "-";
+    static const char digits[] = "0123456789abcdef";
+    string hex;
+    hex.reserve(2 * bytes.size());
+    for (unsigned char c : bytes) {
+        hex += digits[c >> 4];
+        hex += digits[c & 15];
+    }
+    return hex;
+}
+
+inline int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool fromHex(const string& hex, string& bytes) {
+    bytes.clear();
+    if (hex == "-") return true;
+    if (hex.size() % 2 != 0) return false;
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int high = hexDigit(hex[i]);
+        int low = hexDigit(hex[i + 1]);
+        if (high < 0 || low < 0) return false;
+        bytes += (char)(high << 4 | low);
+    }
+    return true;
+}
+
+// Append records a worker sent back in a single write, like appendGameRecord
+bool appendRecords(const string& path, const string& bytes) {
+    if (bytes.empty()) return true;
+    FILE* out = fopen(path.c_str(), "ab");
+    if (!out) return false;
+    bool written = fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    return fclose(out) == 0 && written;
+}
+
+// Bot file flattened to one protocol line
+string readBotBlob(const string& path) {
+    ifstream in(path);
+    vector<int> values;
+    int value;
+    while (in >> value) values.push_back(value);
+
+    string blob = "BOT " + to_string(values.size());
+    for (int v : values) blob += " " + to_string(v);
+    return blob + "\n";
+}
+
+bool writeBotBlob(const string& line, const string& path) {
+    stringstream fields(line);
+    string label;
+    size_t count = 0;
+    fields >> label >> count;
+    if (label != "BOT") return false;
+
+    ofstream out(path);
+    int value;
+    for (size_t i = 0; i < count && fields >> value; i++) {
+        out << value << (i + 1 < count ? " " : "\n");
+    }
+    return !fields.fail() && out.good();
+}
+
+// Hands jobs to remote workers and requeues the job of any worker that disconnects
+class WorkerPool {
+    public:
+        bool listenOn(int port) {
+            signal(SIGPIPE, SIG_IGN); // a dead worker shows up as a failed send instead
+            listenFd = socket(AF_INET6, SOCK_STREAM, 0);
+            if (listenFd < 0) return false;
+            int yes = 1;
+            int no = 0;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            setsockopt(listenFd, IPPROTO_IPV6, IPV6_V6ONLY, &no, sizeof(no)); // accept IPv4 workers too
+
+            sockaddr_in6 address = {};
+            address.sin6_family = AF_INET6;
+            address.sin6_addr = in6addr_any;
+            address.sin6_port = htons(port);
+            if (::bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0) return false;
+            return listen(listenFd, 64) == 0;
+        }
+
+        void runJobs(vector<MatchJob>& jobs, const SPRTConfig& sprt, const function<void(size_t)>& onFinished) {
+            deque<size_t> pending;
+            for (size_t i = 0; i < jobs.size(); i++) pending.push_back(i);
+            size_t remaining = jobs.size();
+
+            while (remaining > 0) {
+                // hand out work to idle workers
+                for (Worker& worker : workers) {
+                    if (worker.fd < 0 || !worker.ready || worker.job >= 0 || pending.empty()) continue;
+                    size_t id = pending.front();
+                    pending.pop_front();
+                    worker.job = id;
+                    if (!sendJob(worker, id, jobs[id], sprt)) dropWorker(worker, pending);
+                }
+                if (workers.empty()) {
+                    cout << "Waiting for workers...\n";
+                    cout.flush();
+                }
+
+                vector<pollfd> fds;
+                fds.push_back({listenFd, POLLIN, 0});
+                for (const Worker& worker : workers) fds.push_back({worker.fd, POLLIN, 0});
+                if (poll(fds.data(), fds.size(), -1) < 0) continue;
+
+                for (size_t i = 1; i < fds.size(); i++) {
+                    Worker& worker = workers[i - 1];
+                    if (!fds[i].revents) continue;
+                    if (!worker.reader.fill()) {
+                        dropWorker(worker, pending);
+                        continue;
+                    }
+
+                    string line;
+                    while (worker.fd >= 0 && worker.reader.nextLine(line)) {
+                        stringstream fields(line);
+                        string type;
+                        fields >> type;
+                        if (type == "HELLO") {
+                            string program, version;
+                            fields >> program >> version;
+                            if (program != "prism-worker" || version != "5") { // different job format
+                                dropWorker(worker, pending);
+                                break;
+                            }
+                            worker.ready = true;
+                        } else if (type == "RESULT") {
+                            int id = -1;
+                            int result = 0;
+                            int finalEval = 0;
+                            string hex, records;
+                            fields >> id >> result >> finalEval >> hex;
+                            if (fields.fail() || id != worker.job || !fromHex(hex, records)) {
+                                dropWorker(worker, pending);
+                                break;
+                            }
+                            if (!recordFile.empty() && !appendRecords(recordFile, records)) {
+                                cout << "Error: Could not append games to " << recordFile << "\n";
+                            }
+                            jobs[id].result = result;
+                            jobs[id].finalEval = finalEval;
+                            worker.job = -1;
+                            remaining--;
+                            onFinished(id);
+                        }
+                    }
+                }
+
+                // accept after servicing so worker indices above stay valid
+                if (fds[0].revents & POLLIN) acceptWorker();
+                workers.erase(remove_if(workers.begin(), workers.end(), [](const Worker& worker) {
+                    return worker.fd < 0;
+                }), workers.end());
+            }
+        }
+
+    private:
+        struct Worker {
+            int fd = -1;
+            string name;
+            LineReader reader;
+            bool ready = false;
+            long job = -1;
+        };
+
+        int listenFd = -1;
+        vector<Worker> workers;
+        map<string, string> blobs; // bot path -> protocol line, bots are sent many times
+
+        void acceptWorker() {
+            sockaddr_storage address = {};
+            socklen_t length = sizeof(address);
+            int fd = accept(listenFd, (sockaddr*)&address, &length);
+            if (fd < 0) return;
+            int yes = 1;
+            setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof(yes)); // notice hosts that vanish
+
+            char host[NI_MAXHOST] = "?";
+            char service[NI_MAXSERV] = "?";
+            getnameinfo((sockaddr*)&address, length, host, sizeof(host), service, sizeof(service), NI_NUMERICHOST | NI_NUMERICSERV);
+
+            Worker worker;
+            worker.fd = fd;
+            worker.name = string(host) + ":" + service;
+            worker.reader = LineReader(fd);
+            workers.push_back(worker);
+            cout << "Worker connected: " << worker.name << " (" << workers.size() << " total)\n";
+            cout.flush();
+        }
+
+        void dropWorker(Worker& worker, deque<size_t>& pending) {
+            cout << "Worker lost: " << worker.name;
+            if (worker.job >= 0) {
+                cout << ", requeueing job " << worker.job;
+                pending.push_front(worker.job);
+            }
+            cout << "\n";
+            cout.flush();
+            close(worker.fd);
+            worker.fd = -1;
+            worker.job = -1;
+        }
+
+        const string& blob(const string& path) {
+            auto found = blobs.find(path);
+            if (found == blobs.end()) found = blobs.insert({path, readBotBlob(path)}).first;
+            return found->second;
+        }
+
+        bool sendJob(Worker& worker, size_t id, const MatchJob& job, const SPRTConfig& sprt) {
+            stringstream header;
+            header.precision(17);
+            header << "JOB " << id << " " << job.kind << " " << job.seed << " " << sprt.enabled << " " << sprt.elo0
+                   << " " << sprt.elo1 << " " << sprt.alpha << " " << sprt.beta << " " << sprt.maxPairs << " "
+                   << sprt.openingPlies << " " << adjudication.resignEval << " " << adjudication.resignPlies << " "
+                   << adjudication.drawPlies << " " << adjudication.repetitionDraw << " " << timeControl.base << " "
+                   << timeControl.increment << " " << timeControl.maxDepth << " " << frontierPruning.futility1 << " "
+                   << frontierPruning.futility2 << " " << frontierPruning.razor3 << " " << !recordFile.empty() << "\n";
+            return sendAll(worker.fd, header.str() + blob(job.bot1) + blob(job.bot2));
+        }
+};
+
+WorkerPool* workerPool = nullptr; // set when coordinating remote workers
+
+// Run a batch of jobs, calling onFinished as each one completes (in any order when distributed)
+void runJobs(vector<MatchJob>& jobs, const SPRTConfig& sprt, const function<void(size_t)>& onFinished) {
+    if (workerPool) {
+        workerPool->runJobs(jobs, sprt, onFinished);
+        return;
+    }
+    for (size_t i = 0; i < jobs.size(); i++) {
+        runJobLocally(jobs[i], sprt);
+        onFinished(i);
+    }
+}
+
+// Worker mode: play jobs from a coordinator until it hangs up
+int runWorker(const string& host, const string& port) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    // the coordinator may still be starting, retry for a while
+    int fd = -1;
+    for (int attempt = 0; attempt < 30 && fd < 0; attempt++) {
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) == 0) {
+            for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+                fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+                if (fd >= 0 && connect(fd, address->ai_addr, address->ai_addrlen) < 0) {
+                    close(fd);
+                    fd = -1;
+                }
+            }
+            freeaddrinfo(addresses);
+        }
+        if (fd < 0) sleep(1);
+    }
+    if (fd < 0) {
+        cout << "Error: Could not reach coordinator at " << host << ":" << port << "\n";
         return 1;
     }
-    
-    string botsDir = argv[1];
-    
-    // Remove trailing slash
-    if (botsDir.back() == '/') {
-        botsDir.pop_back();
+
+    signal(SIGPIPE, SIG_IGN);
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof(yes));
+
+    // nobody watches a worker's boards, one line per game is enough
+    quietOutput = true;
+    startQuietOutput();
+
+    // private folders so several workers can share one host
+    string workerId = to_string(getpid());
+    matchDirectory = "./match_temp_" + workerId;
+    string botDirectory = "./worker_" + workerId;
+    string mkdirCmd = "mkdir -p " + botDirectory;
+    system(mkdirCmd.c_str());
+    string bot1 = botDirectory + "/bot1.txt";
+    string bot2 = botDirectory + "/bot2.txt";
+    string ownRecord = recordFile; // this worker's own log, if it was given one
+    string jobRecord = botDirectory + "/games.bin"; // games of one job, sent back to a recording coordinator
+
+    cout << "Connected to coordinator at " << host << ":" << port << "\n";
+    cout.flush();
+    sendAll(fd, "HELLO prism-worker 5\n");
+
+    LineReader reader(fd);
+    string line;
+    int completed = 0;
+    while (reader.readLine(line)) {
+        stringstream fields(line);
+        string type;
+        long id = -1;
+        MatchJob job;
+        SPRTConfig sprt;
+        bool recordGames = false;
+        fields >> type >> id >> job.kind >> job.seed >> sprt.enabled >> sprt.elo0 >> sprt.elo1 >> sprt.alpha
+               >> sprt.beta >> sprt.maxPairs >> sprt.openingPlies >> adjudication.resignEval >> adjudication.resignPlies
+               >> adjudication.drawPlies >> adjudication.repetitionDraw >> timeControl.base >> timeControl.increment
+               >> timeControl.maxDepth >> frontierPruning.futility1 >> frontierPruning.futility2 >> frontierPruning.razor3
+               >> recordGames;
+        if (type != "JOB" || fields.fail()) break;
+
+        string blob1, blob2;
+        if (!reader.readLine(blob1) || !reader.readLine(blob2)) break;
+        if (!writeBotBlob(blob1, bot1) || !writeBotBlob(blob2, bot2)) break;
+        job.bot1 = bot1;
+        job.bot2 = bot2;
+
+        remove(jobRecord.c_str());
+        recordFile = recordGames ? jobRecord : ownRecord;
+        runJobLocally(job, sprt);
+        string records;
+        if (recordGames) {
+            ifstream in(jobRecord, ios::binary);
+            records.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            if (!ownRecord.empty()) appendRecords(ownRecord, records);
+        }
+        string reply = "RESULT " + to_string(id) + " " + to_string(job.result) + " " + to_string(job.finalEval) + " "
+                     + toHex(records) + "\n";
+        if (!sendAll(fd, reply)) break;
+        completed++;
+    }
+
+    close(fd);
+    string cleanupCmd = "rm -rf " + botDirectory;
+    system(cleanupCmd.c_str());
+    cout << "Coordinator closed the connection after " << completed << " jobs\n";
+    return 0;
+}
+
+// Bradley-Terry rating model, refit incrementally as results come in
+class EloSolver {
+    public:
+        EloSolver(int players = 0) : strength(players, 1.0), points(players, 0.0), games(players) {}
+
+        void addResult(int a, int b, double pointsA, int gameCount) {
+            points[a] += pointsA;
+            points[b] += gameCount - pointsA;
+            games[a][b] += gameCount;
+            games[b][a] += gameCount;
+        }
+
+        // minorization-maximization sweeps, warm started from the previous fit so a
+        // new round only needs a few of them
+        int solve(int maxIterations = 500, double tolerance = 1e-7) {
+            for (int iteration = 1; iteration <= maxIterations; iteration++) {
+                double largestChange = 0.0;
+                for (size_t i = 0; i < strength.size(); i++) {
+                    // one virtual draw against a 0 elo anchor keeps unbeaten bots finite
+                    double denominator = 1.0 / (strength[i] + 1.0);
+                    for (const auto& opponent : games[i]) {
+                        denominator += opponent.second / (strength[i] + strength[opponent.first]);
+                    }
+                    double updated = (points[i] + 0.5) / denominator;
+                    largestChange = max(largestChange, fabs(updated - strength[i]) / strength[i]);
+                    strength[i] = updated;
+                }
+                if (largestChange < tolerance) return iteration;
+            }
+            return maxIterations;
+        }
+
+        double getElo(int player) const {
+            return 400.0 * log10(strength[player]);
+        }
+
+        double getPoints(int player) const {
+            return points[player];
+        }
+
+        int getGames(int player) const {
+            int total = 0;
+            for (const auto& opponent : games[player]) total += opponent.second;
+            return total;
+        }
+
+        bool havePlayed(int a, int b) const {
+            return games[a].count(b) > 0;
+        }
+
+        void save(ostream& out) const {
+            out << strength.size() << "\n";
+            out.precision(17);
+            for (size_t i = 0; i < strength.size(); i++) {
+                out << strength[i] << " " << points[i] << " " << games[i].size();
+                for (const auto& opponent : games[i]) {
+                    out << " " << opponent.first << " " << opponent.second;
+                }
+                out << "\n";
+            }
+        }
+
+        void load(istream& in) {
+            size_t players = 0;
+            in >> players;
+            strength.assign(players, 1.0);
+            points.assign(players, 0.0);
+            games.assign(players, map<int, int>());
+            for (size_t i = 0; i < players; i++) {
+                size_t opponents = 0;
+                in >> strength[i] >> points[i] >> opponents;
+                for (size_t j = 0; j < opponents; j++) {
+                    int opponent = 0;
+                    int count = 0;
+                    in >> opponent >> count;
+                    games[i][opponent] = count;
+                }
+            }
+        }
+
+    private:
+        vector<double> strength; // 10^(elo / 400)
+        vector<double> points;
+        vector<map<int, int>> games; // games played against each opponent
+};
+
+// Swiss pairings: sort by current rating and pair neighbours, avoiding rematches where possible
+vector<pair<int, int>> swissPairings(int players, const EloSolver& solver, vector<bool>& hadBye) {
+    vector<int> order(players);
+    for (int i = 0; i < players; i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return solver.getElo(a) > solver.getElo(b);
+    });
+
+    // odd count: lowest rated bot without a bye sits out
+    if (players % 2 == 1) {
+        for (int i = players - 1; i >= 0; i--) {
+            if (!hadBye[order[i]]) {
+                hadBye[order[i]] = true;
+                order.erase(order.begin() + i);
+                break;
+            }
+        }
+        if ((int)order.size() == players) order.pop_back();
+    }
+
+    vector<pair<int, int>> pairings;
+    vector<bool> paired(order.size(), false);
+    for (size_t i = 0; i < order.size(); i++) {
+        if (paired[i]) continue;
+        size_t opponent = order.size();
+        for (size_t j = i + 1; j < order.size(); j++) { // closest rated fresh opponent
+            if (!paired[j] && !solver.havePlayed(order[i], order[j])) {
+                opponent = j;
+                break;
+            }
+        }
+        if (opponent == order.size()) { // everyone left is a rematch
+            for (size_t j = i + 1; j < order.size(); j++) {
+                if (!paired[j]) {
+                    opponent = j;
+                    break;
+                }
+            }
+        }
+        paired[i] = true;
+        paired[opponent] = true;
+        pairings.push_back({order[i], order[opponent]});
+    }
+    return pairings;
+}
+
+// Round robin pairings for one round using the circle method, -1 marks a bye
+vector<pair<int, int>> roundRobinPairings(int players, int round) {
+    int slots = players + (players % 2);
+    vector<int> circle(slots);
+    circle[0] = 0;
+    for (int i = 1; i < slots; i++) {
+        circle[i] = 1 + (i - 1 + round) % (slots - 1);
+    }
+
+    vector<pair<int, int>> pairings;
+    for (int i = 0; i < slots / 2; i++) {
+        int a = circle[i];
+        int b = circle[slots - 1 - i];
+        if (a >= players || b >= players) continue; // bye
+        pairings.push_back({a, b});
+    }
+    return pairings;
+}
+
+void printStandings(const vector<string>& bots, const EloSolver& solver, size_t limit) {
+    vector<int> order(bots.size());
+    for (size_t i = 0; i < bots.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return solver.getElo(a) > solver.getElo(b);
+    });
+
+    for (size_t i = 0; i < order.size() && i < limit; i++) {
+        int bot = order[i];
+        char line[128];
+        snprintf(line, sizeof(line), "%4zu. %-20s elo %+7.1f  score %.1f/%d\n", i + 1, getFilename(bots[bot]).c_str(),
+                 solver.getElo(bot), solver.getPoints(bot), solver.getGames(bot));
+        cout << line; // through cout so it stays in order with quiet output
     }
-    
-    cout << "Starting tournament.\n";
     cout.flush();
-    
-    vector<string> currentRound = getBotFiles(botsDir);
-    
-    if (currentRound.empty()) {
-        cout << "Error: No bots found in " << botsDir << "\n";
-        return 1;
+}
+
+// Keep one bot of each set with identical weights, the first by name
+void removeDuplicateBots(vector<string>& bots, bool deleteDuplicates) {
+    map<string, string> firstWithHash;
+    vector<string> unique;
+    for (const string& bot : bots) {
+        string hash = botHash(bot);
+        auto first = firstWithHash.find(hash);
+        if (first == firstWithHash.end()) {
+            firstWithHash[hash] = bot;
+            unique.push_back(bot);
+            continue;
+        }
+        cout << getFilename(bot) << " is identical to " << getFilename(first->second) << ", removed\n";
+        if (deleteDuplicates) {
+            string deleteCmd = "rm -f \"" + bot + "\"";
+            system(deleteCmd.c_str());
+        }
     }
-    
-    cout << "Found " << currentRound.size() << " bots\n";
+    if (unique.size() < bots.size()) {
+        cout << "Removed " << bots.size() - unique.size() << " duplicate bots\n";
+        cout.flush();
+    }
+    bots = unique;
+}
+
+// Pre-match screening on a tactical suite
+struct ScreenConfig {
+    string suiteFile;      // empty = no screening
+    int depth = 2;         // search depth per suite position
+    double cull = 0.5;     // fraction of the field removed before the first round
+};
+
+struct SuitePosition {
+    string placement;
+    bool whiteToMove;
+    vector<int> bestMoves;
+    int sign;              // expected eval sign from white's view, 0 = not scored
+};
+
+// Suite lines: <FEN piece placement> <w|b> <best moves, comma separated> <+|-|0>
+bool loadSuite(const string& path, vector<SuitePosition>& suite) {
+    ifstream in(path);
+    if (!in.is_open()) return false;
+
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        stringstream fields(line);
+        SuitePosition position;
+        string side, moves, sign;
+        if (!(fields >> position.placement >> side >> moves >> sign) || !game.setFromFEN(position.placement)) {
+            cout << "Warning: Skipping suite line: " << line << "\n";
+            continue;
+        }
+        position.whiteToMove = side == "w";
+        stringstream list(moves);
+        string move;
+        while (getline(list, move, ',')) {
+            string digits = convertToCoordinates(move);
+            position.bestMoves.push_back(encodeMove(digits[0] - '0', digits[1] - '0', digits[2] - '0', digits[3] - '0'));
+        }
+        position.sign = sign == "+" ? 1 : (sign == "-" ? -1 : 0);
+        suite.push_back(position);
+    }
+    return true;
+}
+
+// One point per best move found and one per correct eval sign
+int screenBot(const BotWeights& weights, const vector<SuitePosition>& suite, int depth) {
+    Evaluator evaluator(weights);
+    Search search(evaluator);
+    search.pruning = frontierPruning;
+    Position board;
+    int score = 0;
+
+    for (const SuitePosition& position : suite) {
+        board.setFromFEN(position.placement);
+        // suite positions carry no castling rights
+        board.whiteKingMoved = board.blackKingMoved = true;
+        board.whiteCastled = board.blackCastled = false;
+
+        int eval = evaluator.evaluate(board);
+        if (position.sign != 0 && (eval > 0 ? 1 : (eval < 0 ? -1 : 0)) == position.sign) score++;
+
+        int move = search.bestMove(board, depth, position.whiteToMove) & 0xFFFF; // castling flag not compared
+        if (find(position.bestMoves.begin(), position.bestMoves.end(), move) != position.bestMoves.end()) score++;
+    }
+    return score;
+}
+
+// Suite score of every bot, each thread screening every threads-th bot with its own evaluator and search
+vector<int> screenBots(const vector<string>& bots, const vector<SuitePosition>& suite, int depth) {
+    vector<int> scores(bots.size(), 0);
+    int threads = max(1, min((int)thread::hardware_concurrency(), (int)bots.size()));
+
+    auto screenSlice = [&](int first) {
+        for (size_t i = first; i < bots.size(); i += threads) {
+            BotWeights weights;
+            importPieceSquareTables(bots[i], weights, false);
+            scores[i] = screenBot(weights, suite, depth);
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(screenSlice, t);
+    screenSlice(0);
+    for (thread& worker : workers) worker.join();
+    return scores;
+}
+
+// Screen and drop the bottom of the field, deleting culled bots when they would be deleted anyway
+void screenField(vector<string>& bots, const ScreenConfig& config, bool deleteCulled) {
+    vector<SuitePosition> suite;
+    if (!loadSuite(config.suiteFile, suite) || suite.empty()) {
+        cout << "Warning: No usable screening suite at " << config.suiteFile << ", skipping screening\n";
+        return;
+    }
+
+    Timer timer;
+    timer.start();
+    vector<int> scores = screenBots(bots, suite, config.depth);
+    timer.stop();
+
+    vector<int> order(bots.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return scores[a] > scores[b];
+    });
+
+    int maxScore = 0;
+    for (const SuitePosition& position : suite) maxScore += 1 + (position.sign != 0);
+    size_t keep = max((size_t)2, bots.size() - (size_t)(bots.size() * config.cull));
+    keep = min(keep, bots.size());
+
+    vector<string> kept;
+    for (size_t i = 0; i < bots.size(); i++) {
+        if (i < keep) {
+            kept.push_back(bots[order[i]]);
+        } else if (deleteCulled) {
+            string deleteCmd = "rm -f \"" + bots[order[i]] + "\"";
+            system(deleteCmd.c_str());
+        }
+    }
+
+    cout << "Screened " << bots.size() << " bots on " << suite.size() << " positions at depth " << config.depth
+         << " in " << timer.getTime() << "s: kept " << keep << " scoring " << scores[order[keep - 1]] << ".."
+         << scores[order[0]] << " of " << maxScore << ", culled " << bots.size() - keep << "\n";
     cout.flush();
-    
+
+    sort(kept.begin(), kept.end());
+    bots = kept;
+}
+
+// Everything needed to continue a tournament, snapshotted at the start of every round
+struct TournamentState {
+    string format = "knockout";
+    int rounds = 0;                // rated formats only
     int roundNumber = 1;
+    SPRTConfig sprt;
+    mt19937 rng;                   // all scheduling randomness, so a resume replays identically
+    vector<string> currentRound;   // knockout: bots still in, rated: the whole population
     map<string, int> consecutiveTies;
     map<string, vector<int>> tieEvaluations; // track evaluations for repetitive ties
-    
+    EloSolver solver;              // rated formats only
+    vector<bool> hadBye;
+    vector<int> seat;
+    Adjudication adjudication;     // game rules, the same for every round
+    TimeControl timeControl;
+    FrontierPruning pruning;
+};
+
+void writeBotList(ostream& out, const string& label, const vector<string>& bots) {
+    out << label << " " << bots.size() << "\n";
+    for (const string& bot : bots) out << bot << "\n";
+}
+
+vector<string> readBotList(istream& in) {
+    string label;
+    size_t count = 0;
+    in >> label >> count;
+    in.ignore(); // rest of the line
+    vector<string> bots(count);
+    for (size_t i = 0; i < count; i++) getline(in, bots[i]);
+    return bots;
+}
+
+// Write the snapshot to a temporary file first so a kill mid write leaves the old one intact
+bool saveSnapshot(const string& path, const TournamentState& state) {
+    string tempPath = path + ".tmp";
+    ofstream out(tempPath);
+    if (!out) return false;
+
+    out << "prism-tournament-snapshot 2\n";
+    out << "format " << state.format << "\n";
+    out << "rounds " << state.rounds << "\n";
+    out << "round " << state.roundNumber << "\n";
+    out.precision(17);
+    out << "sprt " << state.sprt.enabled << " " << state.sprt.elo0 << " " << state.sprt.elo1 << " " << state.sprt.alpha
+        << " " << state.sprt.beta << " " << state.sprt.maxPairs << " " << state.sprt.openingPlies << "\n";
+    out << "rules " << state.adjudication.resignEval << " " << state.adjudication.resignPlies << " "
+        << state.adjudication.drawPlies << " " << state.adjudication.repetitionDraw << " " << state.timeControl.base << " "
+        << state.timeControl.increment << " " << state.timeControl.maxDepth << " " << state.pruning.futility1 << " "
+        << state.pruning.futility2 << " " << state.pruning.razor3 << "\n";
+    out << "rng " << state.rng << "\n";
+    writeBotList(out, "bots", state.currentRound);
+
+    out << "ties " << state.consecutiveTies.size() << "\n";
+    for (const auto& ties : state.consecutiveTies) out << ties.second << " " << ties.first << "\n";
+    out << "tieevals " << state.tieEvaluations.size() << "\n";
+    for (const auto& evals : state.tieEvaluations) {
+        out << evals.second.size();
+        for (int eval : evals.second) out << " " << eval;
+        out << " " << evals.first << "\n";
+    }
+
+    out << "byes " << state.hadBye.size();
+    for (bool bye : state.hadBye) out << " " << bye;
+    out << "\nseats " << state.seat.size();
+    for (int seat : state.seat) out << " " << seat;
+    out << "\nsolver ";
+    state.solver.save(out);
+
+    out.close();
+    if (!out) return false;
+    return rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+bool loadSnapshot(const string& path, TournamentState& state) {
+    ifstream in(path);
+    string label;
+    int version = 0;
+    if (!(in >> label >> version) || label != "prism-tournament-snapshot" || version < 1 || version > 2) return false;
+
+    in >> label >> state.format;
+    in >> label >> state.rounds;
+    in >> label >> state.roundNumber;
+    in >> label >> state.sprt.enabled >> state.sprt.elo0 >> state.sprt.elo1 >> state.sprt.alpha
+       >> state.sprt.beta >> state.sprt.maxPairs >> state.sprt.openingPlies;
+    if (version >= 2) { // version 1 kept no rules, they stay as given
+        in >> label >> state.adjudication.resignEval >> state.adjudication.resignPlies >> state.adjudication.drawPlies
+           >> state.adjudication.repetitionDraw >> state.timeControl.base >> state.timeControl.increment
+           >> state.timeControl.maxDepth >> state.pruning.futility1 >> state.pruning.futility2 >> state.pruning.razor3;
+    }
+    in >> label >> state.rng;
+    state.currentRound = readBotList(in);
+
+    size_t count = 0;
+    in >> label >> count;
+    for (size_t i = 0; i < count; i++) {
+        int ties = 0;
+        string bot;
+        in >> ties;
+        in.ignore();
+        getline(in, bot);
+        state.consecutiveTies[bot] = ties;
+    }
+    in >> label >> count;
+    for (size_t i = 0; i < count; i++) {
+        size_t evals = 0;
+        in >> evals;
+        vector<int> values(evals);
+        for (size_t j = 0; j < evals; j++) in >> values[j];
+        string bot;
+        in.ignore();
+        getline(in, bot);
+        state.tieEvaluations[bot] = values;
+    }
+
+    in >> label >> count;
+    state.hadBye.assign(count, false);
+    for (size_t i = 0; i < count; i++) {
+        int bye = 0;
+        in >> bye;
+        state.hadBye[i] = bye;
+    }
+    in >> label >> count;
+    state.seat.assign(count, 0);
+    for (size_t i = 0; i < count; i++) in >> state.seat[i];
+    in >> label;
+    state.solver.load(in);
+
+    return !in.fail();
+}
+
+// Append only log of finished matches, one tab separated line per match:
+// round, match index, result, final eval, bot1, bot2
+class Journal {
+    public:
+        Journal(const string& path, bool resume) {
+            if (resume) {
+                ifstream in(path);
+                string line;
+                while (getline(in, line)) {
+                    stringstream fields(line);
+                    Entry entry;
+                    int round = 0;
+                    int match = 0;
+                    fields >> round >> match >> entry.result >> entry.finalEval;
+                    fields.ignore();
+                    getline(fields, entry.name1, '\t');
+                    getline(fields, entry.name2);
+                    if (!fields.fail()) entries[{round, match}] = entry; // a torn last line is ignored
+                }
+            }
+            out.open(path, resume ? ios::app : ios::trunc);
+        }
+
+        // returns true and fills in the recorded outcome if this match already finished
+        bool lookup(int round, int match, const string& name1, const string& name2, int& result, int& finalEval) const {
+            auto found = entries.find({round, match});
+            if (found == entries.end()) return false;
+            if (found->second.name1 != name1 || found->second.name2 != name2) {
+                cout << "Error: journal entry for round " << round << " match " << match << " is "
+                     << found->second.name1 << " vs " << found->second.name2 << ", expected " << name1 << " vs " << name2 << "\n";
+                exit(1);
+            }
+            result = found->second.result;
+            finalEval = found->second.finalEval;
+            return true;
+        }
+
+        void record(int round, int match, const string& name1, const string& name2, int result, int finalEval) {
+            out << round << "\t" << match << "\t" << result << "\t" << finalEval << "\t" << name1 << "\t" << name2 << "\n";
+            out.flush();
+        }
+
+    private:
+        struct Entry {
+            int result = 0;
+            int finalEval = 0;
+            string name1;
+            string name2;
+        };
+        map<pair<int, int>, Entry> entries;
+        ofstream out;
+};
+
+// Swiss or (sub)round robin tournament, every pairing plays one color swapped game pair
+// and no bot is deleted, the result is a rating for the whole population
+void runRatedTournament(TournamentState& state, Journal& journal, const string& snapshotPath) {
+    const vector<string>& bots = state.currentRound;
+    int players = bots.size();
+
+    for (; state.roundNumber <= state.rounds; state.roundNumber++) {
+        saveSnapshot(snapshotPath, state);
+        int round = state.roundNumber;
+        cout << "\nRound " << round << " of " << state.rounds << "\n";
+
+        vector<pair<int, int>> pairings;
+        if (state.format == "swiss") {
+            pairings = swissPairings(players, state.solver, state.hadBye);
+        } else {
+            for (const auto& pairing : roundRobinPairings(players, round - 1)) {
+                pairings.push_back({state.seat[pairing.first], state.seat[pairing.second]});
+            }
+        }
+
+        // schedule the whole round, finished matches come back from the journal
+        vector<MatchJob> matches(pairings.size());
+        vector<MatchJob> jobs;
+        vector<size_t> jobMatch;
+        for (size_t match = 0; match < pairings.size(); match++) {
+            matches[match].kind = 1;
+            matches[match].bot1 = bots[pairings[match].first];
+            matches[match].bot2 = bots[pairings[match].second];
+            matches[match].seed = state.rng();
+            if (!journal.lookup(round, match, getFilename(matches[match].bot1), getFilename(matches[match].bot2),
+                                matches[match].result, matches[match].finalEval)) {
+                jobs.push_back(matches[match]);
+                jobMatch.push_back(match);
+            }
+        }
+        if (jobs.size() < matches.size()) {
+            cout << "Replayed " << matches.size() - jobs.size() << " matches from journal\n";
+        }
+
+        runJobs(jobs, state.sprt, [&](size_t job) {
+            MatchJob& match = matches[jobMatch[job]];
+            match.result = jobs[job].result;
+            match.finalEval = jobs[job].finalEval;
+            journal.record(round, jobMatch[job], getFilename(match.bot1), getFilename(match.bot2), match.result, match.finalEval);
+        });
+
+        for (size_t match = 0; match < pairings.size(); match++) {
+            string name1 = getFilename(matches[match].bot1);
+            string name2 = getFilename(matches[match].bot2);
+            int pairPoints = matches[match].result;
+            state.solver.addResult(pairings[match].first, pairings[match].second, pairPoints / 2.0, 2);
+
+            cout << "\nMatch: " << name1 << " vs " << name2 << "\n";
+            cout << "Result: " << name1 << " " << pairPoints / 2.0 << " - " << (4 - pairPoints) / 2.0 << " " << name2 << "\n";
+            cout.flush();
+        }
+
+        int iterations = state.solver.solve();
+        cout << "\nStandings after round " << round << " (" << iterations << " solver sweeps):\n";
+        printStandings(bots, state.solver, 10);
+    }
+
+    cout << "\nTournament Complete.\n";
+    cout << "Final ranking:\n";
+    printStandings(bots, state.solver, bots.size());
+}
+
+// Single elimination bracket, losers are deleted
+void runKnockout(TournamentState& state, Journal& journal, const string& snapshotPath) {
+    vector<string>& currentRound = state.currentRound;
+    map<string, int>& consecutiveTies = state.consecutiveTies;
+    map<string, vector<int>>& tieEvaluations = state.tieEvaluations;
+
     // keep running until only 1 remains
     while (currentRound.size() > 1) {
+        saveSnapshot(snapshotPath, state);
+        int roundNumber = state.roundNumber;
+        const SPRTConfig& sprt = state.sprt;
+
         cout << "\nRound " << roundNumber << "\n";
         cout << "Bots remaining: " << currentRound.size() << "\n";
         
         // shuffle for random pairings
-        shuffleBots(currentRound);
+        shuffleBots(currentRound, state.rng);
         
         vector<string> nextRound;
-        bool repairRound = false; // if need to replay due to repetitive ties with no clear victor
         
-        // pair bots and run matches
+        // pair bots and play the whole round, finished matches come back from the journal
+        vector<MatchJob> matches(currentRound.size() / 2);
+        vector<MatchJob> jobs;
+        vector<size_t> jobMatch;
+        for (size_t match = 0; match < matches.size(); match++) {
+            matches[match].bot1 = currentRound[2 * match];
+            matches[match].bot2 = currentRound[2 * match + 1];
+            matches[match].seed = state.rng();
+            if (!journal.lookup(roundNumber, match, getFilename(matches[match].bot1), getFilename(matches[match].bot2),
+                                matches[match].result, matches[match].finalEval)) {
+                jobs.push_back(matches[match]);
+                jobMatch.push_back(match);
+            }
+        }
+        if (jobs.size() < matches.size()) {
+            cout << "Replayed " << matches.size() - jobs.size() << " matches from journal\n";
+        }
+
+        runJobs(jobs, sprt, [&](size_t job) {
+            MatchJob& match = matches[jobMatch[job]];
+            match.result = jobs[job].result;
+            match.finalEval = jobs[job].finalEval;
+            journal.record(roundNumber, jobMatch[job], getFilename(match.bot1), getFilename(match.bot2), match.result, match.finalEval);
+        });
+        
         for (size_t i = 0; i < currentRound.size(); i += 2) {
             if (i + 1 < currentRound.size()) {
                 string bot1 = currentRound[i];
@@ -143,14 +1328,18 @@ int main(int argc, char* argv[]) {
                 string name1 = getFilename(bot1);
                 string name2 = getFilename(bot2);
                 
-                cout << "\nMatch: " << name1 << " (white) vs " << name2 << " (black)\n";
+                // colors only mean something for single game pairings
+                string side1 = sprt.enabled ? "" : " (white)";
+                string side2 = sprt.enabled ? "" : " (black)";
+                
+                cout << "\nMatch: " << name1 << side1 << " vs " << name2 << side2 << "\n";
                 cout.flush();
                 
-                int finalEval = 0;
-                int result = runMatch(bot1, bot2, finalEval);
+                int finalEval = matches[i / 2].finalEval;
+                int result = matches[i / 2].result;
                 
                 if (result == 1) {
-                    cout << "Winner: " << name1 << " (white)\n";
+                    cout << "Winner: " << name1 << side1 << "\n";
                     cout.flush();
                     nextRound.push_back(bot1);
                     consecutiveTies[bot1] = 0;
@@ -158,10 +1347,10 @@ int main(int argc, char* argv[]) {
                     tieEvaluations.erase(bot1);
                     tieEvaluations.erase(bot2);
                     // Delete loser
-                    string deleteCmd = "rm \"" + bot2 + "\"";
+                    string deleteCmd = "rm -f \"" + bot2 + "\"";
                     system(deleteCmd.c_str());
                 } else if (result == -1) {
-                    cout << "Winner: " << name2 << " (black)\n";
+                    cout << "Winner: " << name2 << side2 << "\n";
                     cout.flush();
                     nextRound.push_back(bot2);
                     consecutiveTies[bot1] = 0;
@@ -169,7 +1358,7 @@ int main(int argc, char* argv[]) {
                     tieEvaluations.erase(bot1);
                     tieEvaluations.erase(bot2);
                     // Delete loser
-                    string deleteCmd = "rm \"" + bot1 + "\"";
+                    string deleteCmd = "rm -f \"" + bot1 + "\"";
                     system(deleteCmd.c_str());
                 } else {
                     cout << "Draw (Eval: " << finalEval << ")\n";
@@ -177,39 +1366,37 @@ int main(int argc, char* argv[]) {
                     
                     // ties: take the higher eval, or randomly select if eval is 0
                     if (finalEval > 0) {
-                        cout << "White (" << name1 << ") has higher eval, advances\n";
+                        cout << name1 << side1 << " has higher eval, advances\n";
                         cout.flush();
                         nextRound.push_back(bot1);
                         // Delete loser
-                        string deleteCmd = "rm \"" + bot2 + "\"";
+                        string deleteCmd = "rm -f \"" + bot2 + "\"";
                         system(deleteCmd.c_str());
                     } else if (finalEval < 0) {
-                        cout << "Black (" << name2 << ") has higher eval, advances\n";
+                        cout << name2 << side2 << " has higher eval, advances\n";
                         cout.flush();
                         nextRound.push_back(bot2);
                         // Delete loser
-                        string deleteCmd = "rm \"" + bot1 + "\"";
+                        string deleteCmd = "rm -f \"" + bot1 + "\"";
                         system(deleteCmd.c_str());
                     } else {
                         // Evaluation is exactly 0. pick winner randomly
-                        random_device rd;
-                        mt19937 gen(rd());
                         uniform_int_distribution<> dis(0, 1);
-                        int randomWinner = dis(gen);
+                        int randomWinner = dis(state.rng);
                         
                         if (randomWinner == 0) {
                             cout << "Eval is 0. " << name1 << " wins by random selection\n";
                             cout.flush();
                             nextRound.push_back(bot1);
                             // Delete loser
-                            string deleteCmd = "rm \"" + bot2 + "\"";
+                            string deleteCmd = "rm -f \"" + bot2 + "\"";
                             system(deleteCmd.c_str());
                         } else {
                             cout << "Eval is 0. " << name2 << " wins by random selection\n";
                             cout.flush();
                             nextRound.push_back(bot2);
                             // Delete loser
-                            string deleteCmd = "rm \"" + bot1 + "\"";
+                            string deleteCmd = "rm -f \"" + bot1 + "\"";
                             system(deleteCmd.c_str());
                         }
                     }
@@ -223,14 +1410,260 @@ int main(int argc, char* argv[]) {
         }
         
         currentRound = nextRound;
-        roundNumber++;
+        state.roundNumber++;
     }
+    saveSnapshot(snapshotPath, state);
     
     // tournament complete
     cout << "\nTournament Complete.\n";
     string winner = getFilename(currentRound[0]);
     cout << "Champion: " << winner << "\n";
     cout.flush();
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <bots_directory> [options]\n";
+    cout << "       " << program << " <bots_directory> --resume\n";
+    cout << "       " << program << " --match <bot1> <bot2> [options]\n";
+    cout << "Options:\n";
+    cout << "  --sprt                 decide pairings with color swapped game pairs and an SPRT\n";
+    cout << "  --elo0 <elo>           H0 elo difference (default -25)\n";
+    cout << "  --elo1 <elo>           H1 elo difference (default 25)\n";
+    cout << "  --alpha <rate>         false positive rate (default 0.05)\n";
+    cout << "  --beta <rate>          false negative rate (default 0.05)\n";
+    cout << "  --max-pairs <n>        game pairs before falling back to tie breaks (default 10)\n";
+    cout << "  --opening-plies <n>    random opening plies per pair (default 6)\n";
+    cout << "  --format <format>      knockout, swiss or roundrobin (default knockout)\n";
+    cout << "  --rounds <n>           swiss rounds, or opponents per bot in a round robin\n";
+    cout << "  --seed <seed>          seed for pairings and openings (default random)\n";
+    cout << "  --resume               continue from the snapshot and journal in the bots directory, under\n";
+    cout << "                         the game rules it was started with\n";
+    cout << "  --record <file>        append every game to a binary game log (see extract), the cache is not read\n";
+    printAdjudicationUsage();
+    printTimeControlUsage();
+    printPruningUsage();
+    cout << "  --cache <file>         game result cache, shared by later runs (default ./match.cache)\n";
+    cout << "  --no-cache             play every game even if its result is cached\n";
+    cout << "  --screen <suite>       screen bots on a tactical suite first and cull the weakest (see screen-suite.txt)\n";
+    cout << "  --screen-depth <n>     search depth for screening (default 2)\n";
+    cout << "  --screen-cull <f>      fraction of the field culled by screening (default 0.5)\n";
+    cout << "  --quiet                one line per game and buffered output written in the background, no boards\n";
+    cout << "  --log-moves            with --quiet, also one line per move\n";
+    cout << "  --listen <port>        coordinate: hand matches to remote workers instead of playing locally\n";
+    cout << "Worker mode:\n";
+    cout << "       " << program << " [--record <file>] [--cache <file>] [--log-moves] --worker <host> <port>\n";
+    cout << "       (always quiet; adjudication, clock and pruning settings come from the coordinator, and the\n";
+    cout << "       games go back to it when it records them)\n";
+}
+
+int main(int argc, char* argv[]) {
+    cout.setf(ios::unitbuf); // Enable unbuffered output
+    
+    string botsDir;
+    string matchBot1, matchBot2;
+    TournamentState state;
+    SPRTConfig& sprt = state.sprt;
+    bool resume = false;
+    unsigned int seed = random_device()();
+    int listenPort = 0;
+    ScreenConfig screen;
+    vector<int> ruleOptions; // where each game rule option starts, checked against the snapshot on resume
+
+    for (int i = 1; i < argc; i++) {
+        int start = i;
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--match" && i + 2 < argc) {
+            matchBot1 = argv[++i];
+            matchBot2 = argv[++i];
+        } else if (arg == "--sprt") {
+            sprt.enabled = true;
+        } else if (arg == "--elo0" && hasValue) {
+            sprt.elo0 = stod(argv[++i]);
+        } else if (arg == "--elo1" && hasValue) {
+            sprt.elo1 = stod(argv[++i]);
+        } else if (arg == "--alpha" && hasValue) {
+            sprt.alpha = stod(argv[++i]);
+        } else if (arg == "--beta" && hasValue) {
+            sprt.beta = stod(argv[++i]);
+        } else if (arg == "--max-pairs" && hasValue) {
+            sprt.maxPairs = stoi(argv[++i]);
+        } else if (arg == "--opening-plies" && hasValue) {
+            sprt.openingPlies = stoi(argv[++i]);
+        } else if (arg == "--format" && hasValue) {
+            state.format = argv[++i];
+        } else if (arg == "--rounds" && hasValue) {
+            state.rounds = stoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = stoul(argv[++i]);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--record" && hasValue) {
+            recordFile = argv[++i];
+        } else if (parseAdjudicationOption(argc, argv, i)) {
+            // resign and draw rules, passed on to prism-tournament
+            ruleOptions.push_back(start);
+        } else if (parseTimeControlOption(argc, argv, i)) {
+            // clocks, passed on the same way
+            ruleOptions.push_back(start);
+        } else if (parsePruningOption(argc, argv, i)) {
+            // search margins, passed on the same way
+            ruleOptions.push_back(start);
+        } else if (arg == "--cache" && hasValue) {
+            resultCache.path = argv[++i];
+        } else if (arg == "--no-cache") {
+            resultCache.path.clear();
+        } else if (arg == "--screen" && hasValue) {
+            screen.suiteFile = argv[++i];
+        } else if (arg == "--screen-depth" && hasValue) {
+            screen.depth = max(1, stoi(argv[++i]));
+        } else if (arg == "--screen-cull" && hasValue) {
+            screen.cull = max(0.0, min(1.0, stod(argv[++i])));
+        } else if (arg == "--quiet") {
+            quietOutput = true;
+            startQuietOutput();
+        } else if (arg == "--log-moves") {
+            logMoves = true;
+        } else if (arg == "--listen" && hasValue) {
+            listenPort = stoi(argv[++i]);
+        } else if (arg == "--worker" && i + 2 < argc) {
+            string host = argv[++i];
+            string port = argv[++i];
+            return runWorker(host, port);
+        } else if (arg[0] != '-' && botsDir.empty()) {
+            botsDir = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (sprt.elo1 <= sprt.elo0 || sprt.alpha <= 0.0 || sprt.alpha >= 1.0 || sprt.beta <= 0.0 || sprt.beta >= 1.0 || sprt.maxPairs < 1) {
+        cout << "Error: SPRT needs elo0 < elo1, error rates in (0, 1) and at least one pair\n";
+        return 1;
+    }
+
+    // head to head match mode, bots are kept
+    if (!matchBot1.empty()) {
+        sprt.enabled = true;
+        string name1 = getFilename(matchBot1);
+        string name2 = getFilename(matchBot2);
+        cout << "SPRT match: " << name1 << " vs " << name2 << " (elo0 " << sprt.elo0 << ", elo1 " << sprt.elo1
+             << ", alpha " << sprt.alpha << ", beta " << sprt.beta << ")\n";
+
+        int finalEval = 0;
+        int result = runSPRTMatch(matchBot1, matchBot2, sprt, seed, finalEval);
+        if (result == 1) {
+            cout << "Result: " << name1 << " is stronger\n";
+        } else if (result == -1) {
+            cout << "Result: " << name2 << " is stronger\n";
+        } else {
+            cout << "Result: no decision (summed draw eval " << finalEval << " for " << name1 << ")\n";
+        }
+        return 0;
+    }
+
+    if (botsDir.empty() || (state.format != "knockout" && state.format != "swiss" && state.format != "roundrobin")) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    // Remove trailing slash
+    if (botsDir.back() == '/') {
+        botsDir.pop_back();
+    }
+
+    // kept outside the *.txt pattern so they are never mistaken for bots
+    string snapshotPath = botsDir + "/tournament.snapshot";
+    string journalPath = botsDir + "/tournament.journal";
+
+    if (resume) {
+        state = TournamentState();
+        state.adjudication = adjudication;
+        state.timeControl = timeControl;
+        state.pruning = frontierPruning;
+        if (!loadSnapshot(snapshotPath, state)) {
+            cout << "Error: No usable snapshot at " << snapshotPath << "\n";
+            return 1;
+        }
+
+        // the rules are the snapshot's, options given again must not change them
+        adjudication = state.adjudication;
+        timeControl = state.timeControl;
+        frontierPruning = state.pruning;
+        string rules = adjudicationArguments() + timeControlArguments() + pruningArguments();
+        for (int start : ruleOptions) {
+            int i = start;
+            if (!parseAdjudicationOption(argc, argv, i) && !parseTimeControlOption(argc, argv, i)) parsePruningOption(argc, argv, i);
+        }
+        if (adjudicationArguments() + timeControlArguments() + pruningArguments() != rules) {
+            cout << "Error: The tournament was started with" << rules << ", resume without game rule options or with the same ones\n";
+            return 1;
+        }
+        cout << "Resuming " << state.format << " tournament at round " << state.roundNumber << ".\n";
+        cout.flush();
+    } else {
+        cout << "Starting tournament.\n";
+        cout.flush();
+        
+        state.currentRound = getBotFiles(botsDir);
+        
+        if (state.currentRound.empty()) {
+            cout << "Error: No bots found in " << botsDir << "\n";
+            return 1;
+        }
+        
+        cout << "Found " << state.currentRound.size() << " bots\n";
+        cout.flush();
+
+        removeDuplicateBots(state.currentRound, state.format == "knockout");
+
+        if (!screen.suiteFile.empty() && state.currentRound.size() > 2) {
+            screenField(state.currentRound, screen, state.format == "knockout");
+        }
+
+        state.rng.seed(seed);
+        state.adjudication = adjudication;
+        state.timeControl = timeControl;
+        state.pruning = frontierPruning;
+        int players = state.currentRound.size();
+        if (state.format != "knockout") {
+            // full round robin unless limited
+            int maxRounds = players + (players % 2) - 1;
+            if (state.format == "swiss" && state.rounds <= 0) {
+                state.rounds = (int)ceil(log2(players)) + 2;
+            }
+            if (state.format == "roundrobin" && (state.rounds <= 0 || state.rounds > maxRounds)) {
+                state.rounds = maxRounds;
+            }
+
+            state.solver = EloSolver(players);
+            state.hadBye.assign(players, false);
+
+            // random seating so a partial round robin meets random opponents
+            state.seat.resize(players);
+            for (int i = 0; i < players; i++) state.seat[i] = i;
+            shuffle(state.seat.begin(), state.seat.end(), state.rng);
+        }
+    }
+
+    WorkerPool pool;
+    if (listenPort > 0) {
+        if (!pool.listenOn(listenPort)) {
+            cout << "Error: Could not listen on port " << listenPort << "\n";
+            return 1;
+        }
+        workerPool = &pool;
+        cout << "Coordinating workers on port " << listenPort << "\n";
+        cout.flush();
+    }
+
+    Journal journal(journalPath, resume);
+    if (state.format == "knockout") {
+        runKnockout(state, journal, snapshotPath);
+    } else {
+        runRatedTournament(state, journal, snapshotPath);
+    }
     
     return 0;
 }
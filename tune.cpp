@@ -0,0 +1,338 @@
+/*
+ * PRISM Engine V0.7
+ * Texel Tuning of Bot Weights
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "prism-engine.h"
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <thread>
+
+// Positions are stored as ranges into one flat feature array
+struct TrainingPosition {
+    uint32_t first;
+    uint16_t count;
+    float result;         // 1 = white won, 0.5 = draw, 0 = black won
+};
+
+struct Dataset {
+    vector<Feature> features;
+    vector<TrainingPosition> positions;
+};
+
+// Tuning settings
+struct TuneConfig {
+    int epochs = 100;
+    int batchSize = 16384;
+    double learningRate = 1.0;
+    double k = 0.0;        // sigmoid scale, 0 = fit it to the starting weights
+    int threads = 0;
+};
+
+bool parseResult(const string& text, float& result) {
+    if (text == "1-0" || text == "1" || text == "1.0") result = 1.0f;
+    else if (text == "0-1" || text == "0" || text == "0.0") result = 0.0f;
+    else if (text == "1/2-1/2" || text == "0.5" || text == "=") result = 0.5f;
+    else return false;
+    return true;
+}
+
+// Text dataset, one position per line: <FEN piece placement> [other FEN fields] <result>
+// with the result as 1-0, 0-1, 1/2-1/2 or 1, 0, 0.5 from white's point of view
+bool loadTextDataset(const string& path, Dataset& data) {
+    ifstream in(path);
+    if (!in.is_open()) return false;
+
+    string line;
+    long skipped = 0;
+    while (getline(in, line)) {
+        stringstream fields(line);
+        string placement, field, last;
+        if (!(fields >> placement)) continue;
+        while (fields >> field) last = field;
+
+        TrainingPosition position;
+        bool bothKings = placement.find('K') != string::npos && placement.find('k') != string::npos;
+        if (!game.setFromFEN(placement) || !parseResult(last, position.result) || !bothKings) {
+            skipped++;
+            continue;
+        }
+        position.first = data.features.size();
+        extractFeatures(game, data.features);
+        position.count = data.features.size() - position.first;
+        data.positions.push_back(position);
+    }
+    if (skipped > 0) cout << "Skipped " << skipped << " unusable lines\n";
+    return true;
+}
+
+// Binary training file written by extract
+bool loadTrainingFile(const string& path, Dataset& data) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (!in) return false;
+
+    char tag[8];
+    if (fread(tag, 1, 8, in) != 8 || memcmp(tag, trainingFileTag, 8) != 0) {
+        fclose(in);
+        return false;
+    }
+
+    long skipped = 0;
+    TrainingRecord records[4096];
+    size_t count;
+    while ((count = fread(records, sizeof(TrainingRecord), 4096, in)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            unpackBoard(records[i].squares);
+            bool whiteKing = false, blackKing = false;
+            for (int r = 0; r < 8; r++) {
+                for (int f = 0; f < 8; f++) {
+                    if (game.board[r][f] == 'K') whiteKing = true;
+                    if (game.board[r][f] == 'k') blackKing = true;
+                }
+            }
+            if (!whiteKing || !blackKing || records[i].result < -1 || records[i].result > 1) {
+                skipped++;
+                continue;
+            }
+            TrainingPosition position;
+            position.result = (records[i].result + 1) / 2.0f;
+            position.first = data.features.size();
+            extractFeatures(game, data.features);
+            position.count = data.features.size() - position.first;
+            data.positions.push_back(position);
+        }
+    }
+    fclose(in);
+    if (skipped > 0) cout << "Skipped " << skipped << " unusable records\n";
+    return true;
+}
+
+// Training file if it carries the extract tag, text otherwise
+bool loadDataset(const string& path, Dataset& data) {
+    ifstream probe(path, ios::binary);
+    char tag[8] = {0};
+    probe.read(tag, 8);
+    if (probe.gcount() == 8 && memcmp(tag, trainingFileTag, 8) == 0) {
+        return loadTrainingFile(path, data);
+    }
+    return loadTextDataset(path, data);
+}
+
+inline double positionEval(const Dataset& data, const TrainingPosition& position, const double* weights) {
+    double eval = 0.0;
+    const Feature* feature = &data.features[position.first];
+    for (int i = 0; i < position.count; i++) {
+        eval += feature[i].coefficient * weights[feature[i].index];
+    }
+    return eval;
+}
+
+inline double sigmoid(double x) {
+    return 1.0 / (1.0 + exp(-x));
+}
+
+// Run body(thread, begin, end) over [0, count) split across threads
+template <typename Body>
+void parallelFor(size_t count, int threads, Body body) {
+    vector<thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end = min(count, begin + chunk);
+        if (begin >= end) break;
+        workers.emplace_back(body, t, begin, end);
+    }
+    for (thread& worker : workers) worker.join();
+}
+
+// Mean squared error between results and predicted scores
+double datasetLoss(const Dataset& data, const double* weights, double k, int threads) {
+    vector<double> partial(threads, 0.0);
+    parallelFor(data.positions.size(), threads, [&](int t, size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            double error = data.positions[i].result - sigmoid(k * positionEval(data, data.positions[i], weights));
+            sum += error * error;
+        }
+        partial[t] = sum;
+    });
+    double total = 0.0;
+    for (double sum : partial) total += sum;
+    return total / data.positions.size();
+}
+
+// Golden section search for the sigmoid scale that best fits the starting weights
+double fitScale(const Dataset& data, const double* weights, int threads) {
+    double low = log(1e-6);
+    double high = log(1.0);
+    const double ratio = (sqrt(5.0) - 1.0) / 2.0;
+    for (int i = 0; i < 40; i++) {
+        double a = high - ratio * (high - low);
+        double b = low + ratio * (high - low);
+        if (datasetLoss(data, weights, exp(a), threads) < datasetLoss(data, weights, exp(b), threads)) {
+            high = b;
+        } else {
+            low = a;
+        }
+    }
+    return exp((low + high) / 2.0);
+}
+
+// Keep values inside the ranges mutate allows
+void clampWeights(double* weights) {
+    for (int i = 0; i < 714; i++) {
+        if (i < 6) weights[i] = max(1.0, min(1000.0, weights[i]));
+        else weights[i] = max(-200.0, min(200.0, weights[i]));
+    }
+}
+
+// Minibatch gradient descent with Adam on the mean squared error
+void tuneWeights(const Dataset& data, double* weights, const TuneConfig& config, int threads) {
+    vector<double> m(714, 0.0);
+    vector<double> v(714, 0.0);
+    const double beta1 = 0.9;
+    const double beta2 = 0.999;
+    long step = 0;
+
+    vector<uint32_t> order(data.positions.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    mt19937 gen(12345);
+
+    vector<vector<double>> partial(threads, vector<double>(714));
+    for (int epoch = 1; epoch <= config.epochs; epoch++) {
+        shuffle(order.begin(), order.end(), gen);
+
+        for (size_t batch = 0; batch < order.size(); batch += config.batchSize) {
+            size_t batchEnd = min(order.size(), batch + (size_t)config.batchSize);
+
+            parallelFor(batchEnd - batch, threads, [&](int t, size_t begin, size_t end) {
+                vector<double>& gradient = partial[t];
+                fill(gradient.begin(), gradient.end(), 0.0);
+                for (size_t i = batch + begin; i < batch + end; i++) {
+                    const TrainingPosition& position = data.positions[order[i]];
+                    double predicted = sigmoid(config.k * positionEval(data, position, weights));
+                    // d(error^2)/d(eval), the 2 and k are folded into the step size
+                    double scale = (predicted - position.result) * predicted * (1.0 - predicted);
+                    const Feature* feature = &data.features[position.first];
+                    for (int f = 0; f < position.count; f++) {
+                        gradient[feature[f].index] += scale * feature[f].coefficient;
+                    }
+                }
+            });
+
+            step++;
+            double batchScale = 1.0 / (batchEnd - batch);
+            for (int i = 0; i < 714; i++) {
+                double gradient = 0.0;
+                for (int t = 0; t < threads; t++) gradient += partial[t][i];
+                gradient *= batchScale;
+                m[i] = beta1 * m[i] + (1.0 - beta1) * gradient;
+                v[i] = beta2 * v[i] + (1.0 - beta2) * gradient * gradient;
+                double mHat = m[i] / (1.0 - pow(beta1, step));
+                double vHat = v[i] / (1.0 - pow(beta2, step));
+                weights[i] -= config.learningRate * mHat / (sqrt(vHat) + 1e-12);
+            }
+            clampWeights(weights);
+        }
+
+        if (epoch == 1 || epoch % 10 == 0 || epoch == config.epochs) {
+            cout << "Epoch " << epoch << ": loss " << datasetLoss(data, weights, config.k, threads) << "\n";
+            cout.flush();
+        }
+    }
+}
+
+void printUsage(const char* program) {
+    cout << "Usage: " << program << " <dataset> <output_bot> [options]\n";
+    cout << "Dataset: a training file from extract, or text lines of\n";
+    cout << "         <FEN piece placement> [FEN fields] <result: 1-0, 0-1, 1/2-1/2>\n";
+    cout << "Options:\n";
+    cout << "  --init <bot>           starting weights (default: plain material, zero tables)\n";
+    cout << "  --epochs <n>           passes over the dataset (default 100)\n";
+    cout << "  --batch <n>            positions per gradient step (default 16384)\n";
+    cout << "  --lr <rate>            Adam step size in weight units (default 1.0)\n";
+    cout << "  --k <scale>            sigmoid scale (default: fitted to the starting weights)\n";
+    cout << "  --threads <n>          worker threads (default: all cores)\n";
+}
+
+int main(int argc, char* argv[]) {
+    cout.setf(ios::unitbuf); // Enable unbuffered output
+
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string datasetPath = argv[1];
+    string outputBot = argv[2];
+    string initBot;
+    TuneConfig config;
+
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--init" && hasValue) {
+            initBot = argv[++i];
+        } else if (arg == "--epochs" && hasValue) {
+            config.epochs = stoi(argv[++i]);
+        } else if (arg == "--batch" && hasValue) {
+            config.batchSize = max(1, stoi(argv[++i]));
+        } else if (arg == "--lr" && hasValue) {
+            config.learningRate = stod(argv[++i]);
+        } else if (arg == "--k" && hasValue) {
+            config.k = stod(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = stoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    int threads = config.threads > 0 ? config.threads : max(1u, thread::hardware_concurrency());
+
+    // starting point
+    BotWeights start = {};
+    if (!initBot.empty()) {
+        importPieceSquareTables(initBot, start);
+    } else {
+        int material[6] = {100, 300, 300, 500, 900, 1};
+        for (int i = 0; i < 6; i++) start.materialValues[i] = material[i];
+    }
+    vector<double> weights(714);
+    const int* startValues = &start.materialValues[0];
+    for (int i = 0; i < 714; i++) weights[i] = startValues[i];
+
+    Dataset data;
+    if (!loadDataset(datasetPath, data)) {
+        cout << "Error: Could not open " << datasetPath << "\n";
+        return 1;
+    }
+    if (data.positions.empty()) {
+        cout << "Error: No usable positions in " << datasetPath << "\n";
+        return 1;
+    }
+    cout << "Loaded " << data.positions.size() << " positions (" << data.features.size() << " features)\n";
+
+    if (config.k <= 0.0) {
+        config.k = fitScale(data, weights.data(), threads);
+        cout << "Fitted sigmoid scale k = " << config.k << "\n";
+    }
+    cout << "Starting loss " << datasetLoss(data, weights.data(), config.k, threads) << " with " << threads << " threads\n";
+
+    Timer timer;
+    timer.start();
+    tuneWeights(data, weights.data(), config, threads);
+    timer.stop();
+
+    BotWeights tuned;
+    int* tunedValues = &tuned.materialValues[0];
+    for (int i = 0; i < 714; i++) tunedValues[i] = (int)lround(weights[i]);
+    writeBotWeights(outputBot, tuned);
+    cout << "Tuned in " << timer.getTime() << " seconds, written to " << outputBot << "\n";
+
+    return 0;
+}